@@ -105,7 +105,7 @@ auto App::run(config::Recorder const& config) -> int {
 		// prepare and inject the game-sepcific types
 		constexpr sag::santorini::Dimensions dim =  // avoid using 5x5x2, to keep app tests short
 			{.rows = 3, .cols = 3, .player_unit_count = 1};
-		using TGraph = sag::santorini::Graph<dim>;
+		using TGraph = sag::santorini::BudgetedGraph<dim>;
 		using TStorage =
 			sag::storage::SQLiteMatchStorage<sag::santorini::StateConverter<dim>, sag::santorini::ActionConverter>;
 		using TRec = sag::match::MatchRecorder<TGraph, TStorage>;
@@ -118,6 +118,15 @@ auto App::run(config::Recorder const& config) -> int {
 			return 1;
 		}
 
+		// share the memory budget equally among the games
+		size_t graph_byte_budget = TGraph::container::unlimited;
+		if (config.graph_memory_budget_mb > 0 && config.parallel_games > 0) {
+			// budgets beyond the addressable bytes are clamped to unlimited instead of wrapping around
+			if (config.graph_memory_budget_mb <= TGraph::container::unlimited / 1_MiB)
+				graph_byte_budget = config.graph_memory_budget_mb * 1_MiB / config.parallel_games;
+			logger->info("graph memory budget per game: {:L} bytes", graph_byte_budget);
+		}
+
 		// prepare and start recorder threads acc. to configuration
 		std::vector<sag::match::RecorderThreadHandle<TRec>> recorder_threads;
 		recorder_threads.reserve(config.parallel_games);
@@ -137,7 +146,11 @@ auto App::run(config::Recorder const& config) -> int {
 			auto recorder_logger = std::make_shared<spdlog::logger>(create_logger(fmt::format("rec-{}", i), config.log));
 			auto sql_connection = std::make_unique<tools::SQLiteConnection>(db_file_path, false, recorder_logger);
 			TStorage storage{std::move(sql_connection)};
-			TRec recorder{std::move(players), {}, {}, std::move(storage), std::move(recorder_logger)};
+			TRec recorder{std::move(players),
+				typename TGraph::container{graph_byte_budget},
+				{},
+				std::move(storage),
+				std::move(recorder_logger)};
 
 			recorder_threads.emplace_back(std::move(recorder));
 		}
@@ -177,6 +190,7 @@ auto App::create_example_config() -> config::Recorder {
 	return config::Recorder{
 		.db_file_path = "recorder-db.sqlite",
 		.parallel_games = 4,
+		.graph_memory_budget_mb = 1024,
 		.players =
 			std::vector<config::Player>{
 				{.name = "player-1", .mcts = {.explore_constant = 0.5, .sample_uniformly = true, .simulations = 1000}},
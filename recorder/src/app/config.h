@@ -93,12 +93,12 @@ void optional_from_json(const nl::json& j, const char* name, std::optional<T>& v
 		value = std::nullopt;
 }
 
-static auto to_json(nl::json& json, const Log& log) -> void {
+inline void to_json(nl::json& json, const Log& log) {
 	optional_to_json(json, "console", log.console);
 	optional_to_json(json, "file", log.file);
 }
 
-static void from_json(const nl::json& json, Log& log) {
+inline void from_json(const nl::json& json, Log& log) {
 	optional_from_json(json, "console", log.console);
 	optional_from_json(json, "file", log.file);
 }
@@ -106,12 +106,29 @@ static void from_json(const nl::json& json, Log& log) {
 struct Recorder {
 	std::string db_file_path;
 	size_t parallel_games = 1;
+	size_t graph_memory_budget_mb = 0;  // shared by all parallel games, 0 means unlimited
 	std::vector<Player> players;
 	Log log;
 
 	friend auto operator<=>(const Recorder&, const Recorder&) = default;
 };
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Recorder, db_file_path, parallel_games, players, log)
+
+inline void to_json(nl::json& json, const Recorder& recorder) {
+	json["db_file_path"] = recorder.db_file_path;
+	json["parallel_games"] = recorder.parallel_games;
+	json["graph_memory_budget_mb"] = recorder.graph_memory_budget_mb;
+	json["players"] = recorder.players;
+	json["log"] = recorder.log;
+}
+
+inline void from_json(const nl::json& json, Recorder& recorder) {
+	json.at("db_file_path").get_to(recorder.db_file_path);
+	json.at("parallel_games").get_to(recorder.parallel_games);
+	// optional, to keep reading configurations without a budget
+	recorder.graph_memory_budget_mb = json.value("graph_memory_budget_mb", size_t{0});
+	json.at("players").get_to(recorder.players);
+	json.at("log").get_to(recorder.log);
+}
 // NOLINTEND
 
 template <class Config>
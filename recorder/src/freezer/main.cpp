@@ -0,0 +1,58 @@
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <string_view>
+
+#include "sag/FrozenGraphContainer.h"
+#include "sag/TicTacToe.h"
+#include "sag/santorini/Graph.h"
+
+namespace {
+
+constexpr sag::santorini::Dimensions santorini_3x3_1 = {.rows = 3, .cols = 3, .player_unit_count = 1};
+
+template <sag::Graph G>
+auto freeze(std::filesystem::path const& path) -> int {
+	auto logger = spdlog::default_logger();
+	auto const start = std::chrono::steady_clock::now();
+	sag::FrozenGraphHeader const header =
+		sag::freeze_graph<typename G::state, typename G::action>(typename G::rules{}, path);
+	std::chrono::duration<double> const duration = std::chrono::steady_clock::now() - start;
+	logger->info("wrote {:L} states, {:L} actions and {:L} edges to '{}' ({:L} bytes) in {:.1f}s",
+		header.state_count,
+		header.action_count,
+		header.edge_count,
+		path.string(),
+		std::filesystem::file_size(path),
+		duration.count());
+	return 0;
+}
+
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+	auto logger = spdlog::default_logger();
+	try {
+		if (argc != 3) {
+			logger->error("Usage: freezer <GAME> <PATH>");
+			logger->info("(Enumerates the complete graph of the game and writes it as frozen graph file.)");
+			logger->info("GAME: 'tictactoe' or 'santorini-3x3x1' (the size of the app, for 'santorini::FrozenGraph')");
+			return 1;
+		}
+
+		std::string_view const game = argv[1];           // NOLINT(*pointer-arithmetic)
+		std::filesystem::path const path = {argv[2]};  // NOLINT(*pointer-arithmetic)
+		if (game == "tictactoe")
+			return freeze<sag::tic_tac_toe::Graph>(path);
+		if (game == "santorini-3x3x1")
+			return freeze<sag::santorini::FrozenGraph<santorini_3x3_1>>(path);
+
+		logger->error("Unknown game '{}'", game);
+		return 1;
+	} catch (std::exception const& exc) {
+		logger->error("Unhandled exception: {}", exc.what());
+		return 1;
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "GraphConcepts.h"
+#include "tools/BoundedValue.h"
+
+namespace sag {
+
+/// Entry of a Walker alias table: its column is picked with probability 'threshold', else the 'alias' column.
+/// A table of k entries samples from k weighted outcomes in constant time (see 'sample_alias').
+struct AliasEntry {
+	float threshold = 1.0F;
+	std::uint32_t alias = 0;
+
+	friend auto operator<=>(const AliasEntry&, const AliasEntry&) = default;
+};
+
+/// builds the alias table of the edges (Vose's method), normalizing the weights by their sum
+template <typename S>
+auto build_alias_table(std::span<ActionEdge<S> const> edges) -> std::vector<AliasEntry> {
+	size_t const count = edges.size();
+	std::vector<AliasEntry> table(count);
+	float sum = 0.0F;
+	for (auto const& edge : edges)
+		sum += edge.weight().value();
+	if (count < 2 || sum <= 0.0F)
+		return table;
+
+	// scale the weights to an average of 1, then pair each column below 1 with one above
+	std::vector<float> scaled(count);
+	std::vector<std::uint32_t> small;
+	std::vector<std::uint32_t> large;
+	for (std::uint32_t index = 0; index < count; ++index) {
+		scaled[index] = edges[index].weight().value() * static_cast<float>(count) / sum;
+		(scaled[index] < 1.0F ? small : large).push_back(index);
+	}
+	while (!small.empty() && !large.empty()) {
+		std::uint32_t const less = small.back();
+		std::uint32_t const more = large.back();
+		small.pop_back();
+		table[less] = {scaled[less], more};
+		scaled[more] = (scaled[more] + scaled[less]) - 1.0F;
+		if (scaled[more] < 1.0F) {
+			large.pop_back();
+			small.push_back(more);
+		}
+	}
+	// the remaining columns are full (up to rounding errors)
+	for (std::uint32_t const index : small)
+		table[index] = {1.0F, index};
+	for (std::uint32_t const index : large)
+		table[index] = {1.0F, index};
+	return table;
+}
+
+/// the index of the outcome picked by the roll, a single roll selects both the column and the alias
+inline auto sample_alias(std::span<AliasEntry const> table, tools::UnitValue random_roll) -> size_t {
+	assert(!table.empty());
+	auto const scaled = random_roll.value() * static_cast<float>(table.size());
+	size_t const column = std::min(static_cast<size_t>(scaled), table.size() - 1);
+	AliasEntry const entry = table[column];
+	return scaled - static_cast<float>(column) < entry.threshold ? column : entry.alias;
+}
+
+}  // namespace sag
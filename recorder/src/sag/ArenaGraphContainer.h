@@ -0,0 +1,225 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "GraphConcepts.h"
+
+namespace sag {
+
+/// State action graph container drawing all of its node and edge storage from a per-container monotonic arena.
+/// Expansions allocate from the arena without locking or per-allocation bookkeeping, and 'clear_and_reroot' releases
+/// the whole graph at once: no destructor runs per state, the arena just hands its blocks back to the upstream
+/// resource. Hence the states and actions have to be trivially destructible.
+template <typename S, typename A>
+class ArenaGraphContainer {
+	static_assert(std::is_trivially_destructible_v<S> && std::is_trivially_destructible_v<A>,
+		"the graph is released without running destructors");
+
+ public:
+	template <RulesEngine<S, A> R>
+	explicit ArenaGraphContainer(
+		R const& rules_engine, std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+			: upstream_(upstream) {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		for (S const root : rules_engine.list_roots()) {
+			root_data.emplace_back(root, rules_engine.list_actions(root));
+		}
+		reset_roots_to(root_data);
+	}
+
+	/// copies into a fresh arena (of the same upstream resource)
+	ArenaGraphContainer(ArenaGraphContainer const& other)
+			: roots_(other.roots_),
+				upstream_(other.upstream_),
+				arena_(std::make_unique<std::pmr::monotonic_buffer_resource>(upstream_)),
+				data_(std::pmr::polymorphic_allocator<>{arena_.get()}.new_object<Data>(*other.data_)),
+				actions_(other.actions_),
+				edges_(other.edges_) {}
+	/// takes over the arena, the moved-from container is left empty (without roots) in a fresh arena
+	ArenaGraphContainer(ArenaGraphContainer&& other)  // NOLINT(performance-noexcept-move-constructor): new arena
+			: roots_(std::move(other.roots_)),
+				upstream_(other.upstream_),
+				arena_(std::move(other.arena_)),
+				data_(std::exchange(other.data_, nullptr)),
+				actions_(std::exchange(other.actions_, 0)),
+				edges_(std::exchange(other.edges_, 0)) {
+		other.reset_to_empty();
+	}
+	~ArenaGraphContainer() = default;  // the arena releases the graph
+
+	auto operator=(ArenaGraphContainer const& other) -> ArenaGraphContainer& {
+		if (this != &other) {
+			ArenaGraphContainer copy{other};
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+	auto operator=(ArenaGraphContainer&& other)  // NOLINT(performance-noexcept-move-constructor): new arena
+		-> ArenaGraphContainer& {
+		if (this != &other) {
+			roots_ = std::move(other.roots_);
+			upstream_ = other.upstream_;
+			arena_ = std::move(other.arena_);  // releases the former graph
+			data_ = std::exchange(other.data_, nullptr);
+			actions_ = std::exchange(other.actions_, 0);
+			edges_ = std::exchange(other.edges_, 0);
+			other.reset_to_empty();
+		}
+		return *this;
+	}
+
+	friend auto operator==(const ArenaGraphContainer& left, const ArenaGraphContainer& right) -> bool {
+		return left.roots_ == right.roots_ && *left.data_ == *right.data_;
+	}
+
+	[[nodiscard]] auto is_terminal_at(S state) const -> bool { return data_->at(state).actions.empty(); }
+	[[nodiscard]] auto is_expanded_at(S state, A action) const -> bool { return edge_count_at(state, action) > 0; }
+	[[nodiscard]] auto roots() const -> std::vector<S> { return roots_; }
+	[[nodiscard]] auto actions_at(S state) const -> std::vector<A> {
+		auto const& actions = data_->at(state).actions;
+		return {actions.begin(), actions.end()};
+	}
+	[[nodiscard]] auto actions_view_at(S state) const -> std::span<A const> { return data_->at(state).actions; }
+
+	[[nodiscard]] auto edges_at(S state, A action) const -> std::vector<ActionEdge<S>> {
+		auto const& edges = data_->at(state).edges_of(action);
+		return {edges.begin(), edges.end()};
+	}
+	[[nodiscard]] auto edges_view_at(S state, A action) const -> std::span<ActionEdge<S> const> {
+		return data_->at(state).edges_of(action);
+	}
+
+	[[nodiscard]] auto action_count_at(S state) const -> size_t { return data_->at(state).actions.size(); }
+
+	[[nodiscard]] auto edge_count_at(S state, A action) const -> size_t {
+		return data_->at(state).edges_of(action).size();
+	}
+
+	auto add(S state, std::vector<A> actions) -> bool;
+
+	auto clear_and_reroot(std::vector<S> new_roots) -> void {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		for (S root : new_roots) {
+			auto const found = data_->find(root);
+			root_data.emplace_back(root, found != data_->end() ? actions_at(root) : std::vector<A>{});
+		}
+
+		// bulk release, the old graph is never destroyed state by state
+		data_ = nullptr;
+		arena_->release();
+		actions_ = 0;
+		edges_ = 0;
+
+		reset_roots_to(root_data);
+	}
+
+	auto expand_at(
+		S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+		-> bool;
+
+	[[nodiscard]] auto action_count() const -> size_t { return actions_; }
+	[[nodiscard]] auto state_count() const -> size_t { return data_->size(); }
+	[[nodiscard]] auto edge_count() const -> size_t { return edges_; }
+
+ private:
+	using Allocator = std::pmr::polymorphic_allocator<>;
+
+	/// allocator-aware counterpart of 'StateDetails', all of its storage lives in the arena
+	struct Details {
+		using allocator_type = Allocator;
+
+		std::pmr::vector<A> actions;
+		std::pmr::vector<std::pmr::vector<ActionEdge<S>>> edges;
+
+		explicit Details(allocator_type allocator) : actions(allocator), edges(allocator) {}
+		Details(Details const& other, allocator_type allocator)
+				: actions(other.actions, allocator), edges(other.edges, allocator) {}
+		Details(Details&& other, allocator_type allocator)
+				: actions(std::move(other.actions), allocator), edges(std::move(other.edges), allocator) {}
+
+		friend auto operator==(const Details&, const Details&) -> bool = default;
+
+		[[nodiscard]] auto index_of(A const& action) const -> size_t {
+			auto const found = std::ranges::lower_bound(actions, action);
+			if (found == actions.end() || *found != action)
+				throw std::out_of_range("action not found at state in graph container");
+			return static_cast<size_t>(found - actions.begin());
+		}
+		[[nodiscard]] auto edges_of(A const& action) const -> std::pmr::vector<ActionEdge<S>> const& {
+			return edges[index_of(action)];
+		}
+		[[nodiscard]] auto edges_of(A const& action) -> std::pmr::vector<ActionEdge<S>>& {
+			return edges[index_of(action)];
+		}
+	};
+	using Data = std::pmr::unordered_map<S, Details>;
+
+	std::vector<S> roots_;
+
+	std::pmr::memory_resource* upstream_;
+	std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_ =
+		std::make_unique<std::pmr::monotonic_buffer_resource>(upstream_);
+	Data* data_ = nullptr;  // lives in (and is released with) the arena
+
+	size_t actions_{0};
+	size_t edges_{0};
+
+	auto reset_to_empty() -> void {
+		arena_ = std::make_unique<std::pmr::monotonic_buffer_resource>(upstream_);
+		reset_roots_to({});
+	}
+
+	auto reset_roots_to(std::vector<std::pair<S, std::vector<A>>> const& root_data) -> void {
+		data_ = Allocator{arena_.get()}.new_object<Data>();
+		roots_.clear();
+		roots_.reserve(root_data.size());
+		for (auto const& [root, actions] : root_data) {
+			roots_.push_back(root);
+			// initialize roots as unexpanded
+			add(root, actions);
+		}
+	}
+};
+
+template <typename S, typename A>
+auto ArenaGraphContainer<S, A>::add(S state, std::vector<A> actions) -> bool {
+	auto [entry, inserted] = data_->try_emplace(state);
+	if (inserted) {
+		Details& details = entry->second;
+		std::ranges::sort(actions);
+		details.actions.assign(actions.begin(), actions.end());
+		details.edges.resize(actions.size());
+		actions_ += actions.size();
+		return true;
+	}
+	// else return false: state already known/initialised (possibly visited via a different parent, etc.)
+	assert(entry->second.actions.size() == actions.size());
+	return false;
+}
+
+template <typename S, typename A>
+auto ArenaGraphContainer<S, A>::expand_at(
+	S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+	-> bool {
+	auto& edges = data_->at(state).edges_of(action);
+	if (!edges.empty())
+		return false;
+
+	edges_ += new_edges.size();
+	edges.assign(new_edges.begin(), new_edges.end());
+
+	for (auto& [child, actions] : next_states) {
+		add(child, std::move(actions));
+	}
+	return true;
+}
+
+}  // namespace sag
@@ -0,0 +1,288 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "GraphConcepts.h"
+#include "StateDetails.h"
+
+namespace sag {
+
+/// State action graph container with a (soft) memory budget.
+/// Whenever an expansion exceeds the budget, the expansions of *cold* states - i.e. states not accessed since the last
+/// access to a root - are dropped, least recently used first, and all states no longer reachable from the roots are
+/// freed. States accessed since the last root access (the current path of a search starting at the root) are never
+/// evicted, hence the budget may be exceeded as long as they alone do not fit.
+template <typename S, typename A>
+class BudgetedGraphContainer {
+ public:
+	static constexpr size_t unlimited = std::numeric_limits<size_t>::max();
+	/// an eviction frees memory down to this fraction of the budget, to not evict on every following expansion
+	static constexpr double eviction_target = 0.75;
+
+	// estimated memory use per entity (the hash map node of a state incl. its link and bucket)
+	static constexpr size_t bytes_per_state = sizeof(std::pair<S const, StateDetails<S, A>>) + 4 * sizeof(void*);
+	static constexpr size_t bytes_per_action = sizeof(A) + sizeof(std::vector<ActionEdge<S>>);
+	static constexpr size_t bytes_per_edge = sizeof(ActionEdge<S>);
+
+	template <RulesEngine<S, A> R>
+	explicit BudgetedGraphContainer(R const& rules_engine, size_t byte_budget = unlimited) : byte_budget_(byte_budget) {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		for (S const root : rules_engine.list_roots()) {
+			root_data.emplace_back(root, rules_engine.list_actions(root));
+		}
+		reset_roots_to(root_data);
+	}
+
+	/// compares the content only, not the budget or the access history
+	friend auto operator==(const BudgetedGraphContainer& left, const BudgetedGraphContainer& right) -> bool {
+		return left.roots_ == right.roots_ && left.data_ == right.data_;
+	}
+
+	[[nodiscard]] auto is_terminal_at(S state) const -> bool { return details_of(state).actions.empty(); }
+	[[nodiscard]] auto is_expanded_at(S state, A action) const -> bool { return edge_count_at(state, action) > 0; }
+	[[nodiscard]] auto roots() const -> std::vector<S> { return roots_; }
+	[[nodiscard]] auto actions_at(S state) const -> std::vector<A> { return details_of(state).actions; }
+	[[nodiscard]] auto actions_view_at(S state) const -> std::span<A const> { return details_of(state).actions; }
+
+	[[nodiscard]] auto edges_at(S state, A action) const -> std::vector<ActionEdge<S>> {
+		return details_of(state).edges_of(action);
+	}
+	[[nodiscard]] auto edges_view_at(S state, A action) const -> std::span<ActionEdge<S> const> {
+		return details_of(state).edges_of(action);
+	}
+
+	[[nodiscard]] auto action_count_at(S state) const -> size_t { return details_of(state).actions.size(); }
+
+	[[nodiscard]] auto edge_count_at(S state, A action) const -> size_t {
+		return details_of(state).edges_of(action).size();
+	}
+
+	auto add(S state, std::vector<A> actions) -> bool;
+
+	auto clear_and_reroot(std::vector<S> new_roots) -> void {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		for (S root : new_roots) {
+			auto const found = data_.find(root);
+			root_data.emplace_back(root, found != data_.end() ? found->second.details.actions : std::vector<A>{});
+		}
+
+		data_.clear();
+		actions_ = 0;
+		edges_ = 0;
+
+		reset_roots_to(root_data);
+	}
+
+	auto retain_and_reroot(std::vector<S> new_roots) -> RerootResult;
+
+	auto expand_at(
+		S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+		-> bool;
+
+	[[nodiscard]] auto action_count() const -> size_t { return actions_; }
+	[[nodiscard]] auto state_count() const -> size_t { return data_.size(); }
+	[[nodiscard]] auto edge_count() const -> size_t { return edges_; }
+
+	/// estimated memory use in bytes
+	[[nodiscard]] auto memory_usage() const -> size_t {
+		return data_.size() * bytes_per_state + actions_ * bytes_per_action + edges_ * bytes_per_edge;
+	}
+	[[nodiscard]] auto peak_memory_usage() const -> size_t { return std::max(peak_memory_usage_, memory_usage()); }
+	[[nodiscard]] auto byte_budget() const -> size_t { return byte_budget_; }
+	/// total number of states freed by evictions (not by rerooting)
+	[[nodiscard]] auto evicted_state_count() const -> size_t { return evicted_states_; }
+
+ private:
+	using Tick = std::uint64_t;
+
+	struct Node {
+		StateDetails<S, A> details;
+		mutable Tick last_access = 0;
+		bool is_root = false;
+
+		friend auto operator==(const Node& left, const Node& right) -> bool { return left.details == right.details; }
+	};
+
+	std::vector<S> roots_;
+	std::unordered_map<S, Node> data_;
+
+	size_t actions_{0};
+	size_t edges_{0};
+
+	size_t byte_budget_;
+	size_t peak_memory_usage_{0};
+	size_t evicted_states_{0};
+
+	// access history: a logical clock, ticking on each access
+	mutable Tick clock_{0};
+	mutable Tick last_root_access_{0};
+
+	auto touch(Node const& node) const -> void {
+		node.last_access = ++clock_;
+		if (node.is_root)
+			last_root_access_ = node.last_access;
+	}
+
+	[[nodiscard]] auto details_of(S const& state) const -> StateDetails<S, A> const& {
+		Node const& node = data_.at(state);
+		touch(node);
+		return node.details;
+	}
+
+	[[nodiscard]] auto is_cold(Node const& node) const -> bool {
+		return !node.is_root && node.last_access < last_root_access_;
+	}
+
+	/// estimated memory of the expansions of the node and of its children (overestimated if children are shared)
+	[[nodiscard]] auto expansion_memory_of(Node const& node) const -> size_t {
+		size_t result = 0;
+		for (auto const& edges : node.details.edges) {
+			for (ActionEdge<S> const& edge : edges) {
+				result += bytes_per_edge;
+				if (auto const found = data_.find(edge.state()); found != data_.end())
+					result += bytes_per_state + found->second.details.actions.size() * bytes_per_action;
+			}
+		}
+		return result;
+	}
+
+	auto evict() -> void;
+
+	/// frees all states not reachable from the roots, returns the number of freed states
+	auto sweep() -> size_t;
+
+	auto reset_roots_to(std::vector<std::pair<S, std::vector<A>>> const& root_data) -> void {
+		roots_.clear();
+		roots_.reserve(root_data.size());
+		for (auto [root, actions] : root_data) {
+			roots_.push_back(root);
+			// initialize roots as unexpanded
+			Node& node = data_[root];
+			node.details = StateDetails<S, A>(std::move(actions));
+			node.is_root = true;
+			actions_ += node.details.actions.size();
+		}
+	}
+};
+
+template <typename S, typename A>
+auto BudgetedGraphContainer<S, A>::add(S state, std::vector<A> actions) -> bool {
+	auto [entry, inserted] = data_.try_emplace(state);
+	if (inserted) {
+		actions_ += actions.size();
+		entry->second.details = StateDetails<S, A>(std::move(actions));
+		entry->second.last_access = ++clock_;
+		return true;
+	}
+	// else return false: state already known/initialised (possibly visited via a different parent, etc.)
+	assert(entry->second.details.actions.size() == actions.size());
+	return false;
+}
+
+template <typename S, typename A>
+auto BudgetedGraphContainer<S, A>::retain_and_reroot(std::vector<S> new_roots) -> RerootResult {
+	for (S const& root : roots_)
+		data_.at(root).is_root = false;
+	for (S const& root : new_roots) {
+		// unknown roots are initialized without actions
+		data_[root].is_root = true;
+	}
+	roots_ = std::move(new_roots);
+
+	size_t const freed = sweep();
+	return {.kept_states = data_.size(), .freed_states = freed};
+}
+
+template <typename S, typename A>
+auto BudgetedGraphContainer<S, A>::expand_at(
+	S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+	-> bool {
+	Node& node = data_.at(state);
+	touch(node);
+	std::vector<ActionEdge<S>>& edges = node.details.edges_of(action);
+	if (!edges.empty())
+		return false;
+
+	edges_ += new_edges.size();
+	edges = std::move(new_edges);
+	for (auto& [child, actions] : next_states) {
+		add(child, std::move(actions));
+	}
+
+	peak_memory_usage_ = std::max(peak_memory_usage_, memory_usage());
+	if (memory_usage() > byte_budget_)
+		evict();
+	return true;
+}
+
+template <typename S, typename A>
+auto BudgetedGraphContainer<S, A>::evict() -> void {
+	auto const target = static_cast<size_t>(eviction_target * static_cast<double>(byte_budget_));
+
+	// collect the cold expanded states, least recently used first
+	std::vector<std::pair<Tick, S>> candidates;
+	for (auto const& [state, node] : data_) {
+		if (is_cold(node) && std::ranges::any_of(node.details.edges, [](auto const& edges) { return !edges.empty(); }))
+			candidates.emplace_back(node.last_access, state);
+	}
+	std::ranges::sort(candidates, {}, &std::pair<Tick, S>::first);
+
+	// drop expansions until the estimate reaches the target, then sweep (repeat, as the estimate may be too optimistic)
+	size_t next = 0;
+	while (memory_usage() > target && next < candidates.size()) {
+		size_t estimate = memory_usage();
+		for (; next < candidates.size() && estimate > target; ++next) {
+			auto const found = data_.find(candidates[next].second);
+			if (found == data_.end())
+				continue;  // freed by a previous sweep
+			Node& node = found->second;
+			estimate -= std::min(estimate, expansion_memory_of(node));
+			for (auto& edges : node.details.edges) {
+				edges_ -= edges.size();
+				edges = {};  // release the capacity as well
+			}
+		}
+		evicted_states_ += sweep();
+	}
+}
+
+template <typename S, typename A>
+auto BudgetedGraphContainer<S, A>::sweep() -> size_t {
+	// mark all states reachable from the roots
+	std::unordered_set<S> reachable;
+	std::vector<S> pending;
+	for (S const& root : roots_) {
+		if (reachable.insert(root).second)
+			pending.push_back(root);
+	}
+	while (!pending.empty()) {
+		S const state = pending.back();
+		pending.pop_back();
+		for (auto const& edges : data_.at(state).details.edges) {
+			for (ActionEdge<S> const& edge : edges) {
+				if (reachable.insert(edge.state()).second)
+					pending.push_back(edge.state());
+			}
+		}
+	}
+
+	// sweep all others and recount
+	size_t const freed =
+		std::erase_if(data_, [&reachable](auto const& entry) { return !reachable.contains(entry.first); });
+	actions_ = 0;
+	edges_ = 0;
+	for (auto const& [state, node] : data_) {
+		actions_ += node.details.actions.size();
+		for (auto const& edges : node.details.edges)
+			edges_ += edges.size();
+	}
+	return freed;
+}
+
+}  // namespace sag
@@ -0,0 +1,210 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "GraphConcepts.h"
+#include "GraphOperations.h"
+
+namespace sag {
+
+/// Counters of a cache, summed over its shards
+struct CachingStats {
+	size_t hits = 0;
+	size_t misses = 0;
+	size_t evictions = 0;
+
+	[[nodiscard]] auto hit_rate() const -> double {
+		return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+	}
+
+	friend auto operator<=>(const CachingStats&, const CachingStats&) = default;
+};
+
+/// Rules engine adapter memoizing the actions, edges and score of the most recently used states of the wrapped
+/// engine, e.g. for expensive engines queried repeatedly for the same states by selection, expansion and rollouts.
+/// The cache holds at most 'capacity' states in 'shard_count' LRU shards, each behind its own mutex, such that the
+/// adapter may be shared by threads. The wrapped engine computes without holding a lock, threads may then compute the
+/// same result concurrently. Copies start with an empty cache of the same capacity.
+template <typename R>
+class CachingRules {
+ public:
+	using state = typename decltype(std::declval<R const&>().list_roots())::value_type;
+	using action = typename decltype(std::declval<R const&>().list_actions(std::declval<state>()))::value_type;
+	static_assert(RulesEngine<R, state, action>);
+
+	static constexpr size_t shard_count = 16;
+	static constexpr size_t default_capacity = 1 << 16;
+	static constexpr bool is_deterministic = DeterministicRulesEngine<R, state, action>;
+
+	CachingRules() : CachingRules(R{}) {}
+	explicit CachingRules(R rules, size_t capacity = default_capacity)
+			: rules_(std::move(rules)), shard_capacity_(std::max(size_t{1}, capacity / shard_count)) {}
+
+	CachingRules(CachingRules const& other) : CachingRules(other.rules_, other.capacity()) {}
+	CachingRules(CachingRules&&) noexcept = default;
+	auto operator=(CachingRules const& other) -> CachingRules& {
+		if (this != &other)
+			*this = CachingRules(other);
+		return *this;
+	}
+	auto operator=(CachingRules&&) noexcept -> CachingRules& = default;
+	~CachingRules() = default;
+
+	/// concept RulesEngine:
+	[[nodiscard]] auto list_roots() const -> std::vector<state> { return rules_.list_roots(); }
+
+	[[nodiscard]] auto list_actions(state const& vertex) const -> std::vector<action> {
+		return lookup(
+			vertex,
+			[](Entry& entry) { return entry.actions; },
+			[&] { return rules_.list_actions(vertex); },
+			[](Entry& entry, std::vector<action> const& actions) { set_actions(entry, actions); });
+	}
+
+	/// the edges are cached if the actions of the state are
+	[[nodiscard]] auto list_edges(state const& vertex, action const& edge_action) const
+		-> std::vector<ActionEdge<state>> {
+		return lookup(
+			vertex,
+			[&](Entry& entry) -> std::optional<std::vector<ActionEdge<state>>> {
+				auto* const edges = edges_of(entry, edge_action);
+				return edges != nullptr ? *edges : std::nullopt;
+			},
+			[&] { return rules_.list_edges(vertex, edge_action); },
+			[&](Entry& entry, std::vector<ActionEdge<state>> const& edges) {
+				if (auto* const cached = edges_of(entry, edge_action); cached != nullptr)
+					*cached = edges;
+			});
+	}
+
+	[[nodiscard]] auto score(state const& vertex) const -> tools::Score {
+		return lookup(
+			vertex,
+			[](Entry& entry) { return entry.score; },
+			[&] { return rules_.score(vertex); },
+			[](Entry& entry, tools::Score score) { entry.score = score; });
+	}
+
+	/// concept SuccessorListingRulesEngine: in one pass of the wrapped engine, if it supports it
+	[[nodiscard]] auto list_successors(state const& vertex) const -> ActionSuccessors<state, action> {
+		return lookup(
+			vertex,
+			[](Entry& entry) -> std::optional<ActionSuccessors<state, action>> {
+				if (!entry.actions.has_value() ||
+						!std::ranges::all_of(entry.edges, [](auto const& edges) { return edges.has_value(); }))
+					return std::nullopt;
+				ActionSuccessors<state, action> result;
+				for (size_t index = 0; index < entry.actions->size(); ++index)
+					result.emplace_back((*entry.actions)[index], *entry.edges[index]);
+				return result;
+			},
+			[&] { return sag::list_successors<state, action>(rules_, vertex); },
+			[](Entry& entry, ActionSuccessors<state, action> const& successors) {
+				entry.actions.emplace();
+				entry.edges.clear();
+				for (auto const& [listed_action, edges] : successors) {
+					entry.actions->push_back(listed_action);
+					entry.edges.emplace_back(edges);
+				}
+			});
+	}
+
+	[[nodiscard]] auto rules() const -> R const& { return rules_; }
+	[[nodiscard]] auto capacity() const -> size_t { return shard_capacity_ * shard_count; }
+
+	[[nodiscard]] auto stats() const -> CachingStats {
+		CachingStats result;
+		for (Shard& shard : *shards_) {
+			std::scoped_lock const lock(shard.mutex);
+			result.hits += shard.stats.hits;
+			result.misses += shard.stats.misses;
+			result.evictions += shard.stats.evictions;
+		}
+		return result;
+	}
+
+ private:
+	/// results of the wrapped engine for a state, each computed on first request
+	struct Entry {
+		std::optional<std::vector<action>> actions;
+		std::vector<std::optional<std::vector<ActionEdge<state>>>> edges;  // at the index of the action
+		std::optional<tools::Score> score;
+	};
+
+	struct Shard {
+		std::mutex mutex;
+		std::list<std::pair<state, Entry>> recently_used;  // most recent first
+		std::unordered_map<state, typename std::list<std::pair<state, Entry>>::iterator> index;
+		CachingStats stats;
+	};
+
+	R rules_;
+	size_t shard_capacity_;
+	std::unique_ptr<std::array<Shard, shard_count>> shards_ = std::make_unique<std::array<Shard, shard_count>>();
+
+	static auto set_actions(Entry& entry, std::vector<action> const& actions) -> void {
+		if (entry.actions.has_value())
+			return;
+		entry.actions = actions;
+		entry.edges.resize(actions.size());
+	}
+
+	/// the cache slot of the edges of the action, nullptr if the actions are not cached or the action is not legal
+	static auto edges_of(Entry& entry, action const& edge_action) -> std::optional<std::vector<ActionEdge<state>>>* {
+		if (!entry.actions.has_value())
+			return nullptr;
+		auto const found = std::ranges::find(*entry.actions, edge_action);
+		if (found == entry.actions->end())
+			return nullptr;
+		return &entry.edges[static_cast<size_t>(found - entry.actions->begin())];
+	}
+
+	/// answers the query from the entry of the state if cached there ('read'), else computes it by the wrapped engine
+	/// without holding the lock of the shard ('compute') and caches the result ('store'), unless the entry was evicted
+	/// in the meantime. A hit requires the entry to exist, which the query may complete.
+	template <typename Read, typename Compute, typename Store>
+	auto lookup(state const& vertex, Read&& read, Compute&& compute, Store&& store) const {
+		Shard& shard = (*shards_)[std::hash<state>{}(vertex) % shard_count];
+		{
+			std::scoped_lock const lock(shard.mutex);
+			if (auto cached = std::forward<Read>(read)(entry_of(shard, vertex)); cached.has_value())
+				return *std::move(cached);
+		}
+		auto result = std::forward<Compute>(compute)();
+		std::scoped_lock const lock(shard.mutex);
+		auto const found = shard.index.find(vertex);
+		if (found != shard.index.end())
+			std::forward<Store>(store)(found->second->second, result);
+		return result;
+	}
+
+	/// the entry of the state, moved to the front of its shard (created if missing, evicting the least recently used)
+	auto entry_of(Shard& shard, state const& vertex) const -> Entry& {
+		auto const found = shard.index.find(vertex);
+		if (found != shard.index.end()) {
+			++shard.stats.hits;
+			shard.recently_used.splice(shard.recently_used.begin(), shard.recently_used, found->second);
+		} else {
+			++shard.stats.misses;
+			if (shard.index.size() >= shard_capacity_) {
+				shard.index.erase(shard.recently_used.back().first);
+				shard.recently_used.pop_back();
+				++shard.stats.evictions;
+			}
+			shard.recently_used.emplace_front(vertex, Entry{});
+			shard.index.emplace(vertex, shard.recently_used.begin());
+		}
+		return shard.recently_used.front().second;
+	}
+};
+
+}  // namespace sag
@@ -0,0 +1,182 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "GraphConcepts.h"
+#include "GraphOperations.h"
+
+namespace sag {
+
+// clang-format off
+template <typename T, typename S, typename A>
+/// The symmetries of a game: transforms mapping each state to an equivalent one, with the same score and the
+/// correspondingly transformed actions and successors.
+/// REQUIREMENTS:
+/// - transforms are numbered from 0 to 'T::transform_count' (exclusive), transform 0 is the identity.
+/// - 'inverse' is the transform undoing the given one, for states as well as actions.
+/// - 'transform_action' maps the actions of a state to the actions of the transformed state (in any order).
+/// - 'precedes' is a strict total order of the states, the canonical state is the first among its transforms.
+concept Symmetry = Vertices<S, A> && requires(S state, A action, size_t transform) {
+	{ T::transform_count } -> std::convertible_to<size_t>;
+	{ T::transform_state(state, transform) } -> std::same_as<S>;
+	{ T::transform_action(action, transform) } -> std::same_as<A>;
+	{ T::inverse(transform) } -> std::same_as<size_t>;
+	{ T::precedes(state, state) } -> std::same_as<bool>;
+};
+// clang-format on
+
+/// The symmetries of a grid of 'rows' x 'cols' positions, numbered 'col + cols * row': the dihedral group D4 (rotations
+/// and reflections) of a square grid, and the reflections and the half turn of other grids.
+/// Transform t reflects the rows if bit 0 is set, then the columns if bit 1 is set, then transposes if bit 2 is set.
+template <size_t rows, size_t cols>
+struct GridSymmetries {
+	static constexpr size_t position_count = rows * cols;
+	static constexpr size_t transform_count = rows == cols ? 8 : 4;  // NOLINT(*magic-numbers)
+	using Permutation = std::array<unsigned char, position_count>;
+
+	/// 'permutations[t][p]' is the position that t moves position p to
+	static constexpr std::array<Permutation, transform_count> permutations = [] {
+		std::array<Permutation, transform_count> result{};
+		for (size_t transform = 0; transform < transform_count; ++transform) {
+			for (size_t row = 0; row < rows; ++row) {
+				for (size_t col = 0; col < cols; ++col) {
+					size_t to_row = (transform & 1U) != 0 ? rows - 1 - row : row;
+					size_t to_col = (transform & 2U) != 0 ? cols - 1 - col : col;
+					if ((transform & 4U) != 0)  // NOLINT(*magic-numbers)
+						std::swap(to_row, to_col);
+					result[transform][col + cols * row] = static_cast<unsigned char>(to_col + cols * to_row);
+				}
+			}
+		}
+		return result;
+	}();
+
+	/// 'inverses[t]' is the transform moving every position back to where t took it from
+	static constexpr std::array<size_t, transform_count> inverses = [] {
+		std::array<size_t, transform_count> result{};
+		for (size_t transform = 0; transform < transform_count; ++transform) {
+			for (size_t candidate = 0; candidate < transform_count; ++candidate) {
+				bool is_inverse = true;
+				for (size_t position = 0; position < position_count; ++position)
+					is_inverse = is_inverse && permutations[candidate][permutations[transform][position]] == position;
+				if (is_inverse)
+					result[transform] = candidate;
+			}
+		}
+		return result;
+	}();
+};
+
+/// Rules engine adapter identifying the symmetric states of the wrapped engine: it lists only canonical states (as
+/// chosen by the symmetry S) as roots and successors, so that containers and statistics hold each class of symmetric
+/// states once, and expansions and statistics of one state serve all its symmetric counterparts.
+/// 'canonicalize', 'to_canonical' and 'from_canonical' map an arbitrary state and its actions to the canonical state
+/// and back, e.g. to play the actions searched on the canonical state in a game that is not restricted to them.
+template <typename R, typename S>
+class CanonicalRules {
+ public:
+	using state = typename decltype(std::declval<R const&>().list_roots())::value_type;
+	using action = typename decltype(std::declval<R const&>().list_actions(std::declval<state>()))::value_type;
+	static_assert(RulesEngine<R, state, action>);
+	static_assert(Symmetry<S, state, action>);
+
+	static constexpr bool is_deterministic = DeterministicRulesEngine<R, state, action>;
+
+	/// a state as its canonical representative and the transform that maps it there
+	struct Canonical {
+		state canonical_state;
+		size_t transform = 0;
+	};
+
+	CanonicalRules() = default;
+	explicit CanonicalRules(R rules) : rules_(std::move(rules)) {}
+
+	/// concept RulesEngine:
+	[[nodiscard]] auto list_roots() const -> std::vector<state> {
+		std::vector<state> result;
+		for (state const& root : rules_.list_roots()) {
+			state canonical_root = canonicalize(root).canonical_state;
+			if (std::ranges::find(result, canonical_root) == result.end())
+				result.push_back(std::move(canonical_root));
+		}
+		return result;
+	}
+
+	[[nodiscard]] auto list_actions(state const& vertex) const -> std::vector<action> {
+		return rules_.list_actions(vertex);
+	}
+
+	[[nodiscard]] auto list_edges(state const& vertex, action const& edge_action) const
+		-> std::vector<ActionEdge<state>> {
+		return canonical_edges(rules_.list_edges(vertex, edge_action));
+	}
+
+	[[nodiscard]] auto score(state const& vertex) const -> tools::Score { return rules_.score(vertex); }
+
+	/// concept SuccessorListingRulesEngine: in one pass of the wrapped engine, if it supports it
+	[[nodiscard]] auto list_successors(state const& vertex) const -> ActionSuccessors<state, action> {
+		ActionSuccessors<state, action> result = sag::list_successors<state, action>(rules_, vertex);
+		for (auto& [successor_action, edges] : result)
+			edges = canonical_edges(std::move(edges));
+		return result;
+	}
+
+	/// concept CountingRulesEngine: if the wrapped engine supports it
+	[[nodiscard]] auto is_terminal(state const& vertex) const -> bool
+		requires CountingRulesEngine<R, state, action>
+	{
+		return rules_.is_terminal(vertex);
+	}
+
+	[[nodiscard]] auto action_count(state const& vertex) const -> size_t
+		requires CountingRulesEngine<R, state, action>
+	{
+		return rules_.action_count(vertex);
+	}
+
+	[[nodiscard]] static auto canonicalize(state const& vertex) -> Canonical {
+		Canonical result{vertex, 0};
+		for (size_t transform = 1; transform < S::transform_count; ++transform) {
+			state transformed = S::transform_state(vertex, transform);
+			if (S::precedes(transformed, result.canonical_state))
+				result = {std::move(transformed), transform};
+		}
+		return result;
+	}
+
+	/// the action of the canonical state corresponding to an action of the original state
+	[[nodiscard]] static auto to_canonical(action const& original_action, size_t transform) -> action {
+		return S::transform_action(original_action, transform);
+	}
+
+	/// the action of the original state corresponding to an action of the canonical state
+	[[nodiscard]] static auto from_canonical(action const& canonical_action, size_t transform) -> action {
+		return S::transform_action(canonical_action, S::inverse(transform));
+	}
+
+	[[nodiscard]] auto rules() const -> R const& { return rules_; }
+
+ private:
+	R rules_;
+
+	/// edges to canonical states, merging the weights of edges to symmetric states
+	[[nodiscard]] static auto canonical_edges(std::vector<ActionEdge<state>> edges) -> std::vector<ActionEdge<state>> {
+		std::vector<ActionEdge<state>> result;
+		result.reserve(edges.size());
+		for (ActionEdge<state> const& edge : edges) {
+			state canonical_state = canonicalize(edge.state()).canonical_state;
+			auto const same_state = std::ranges::find_if(
+				result, [&canonical_state](ActionEdge<state> const& merged) { return merged.state() == canonical_state; });
+			if (same_state == result.end())
+				result.emplace_back(edge.weight().value(), std::move(canonical_state));
+			else
+				*same_state = ActionEdge<state>(same_state->weight().value() + edge.weight().value(), same_state->state());
+		}
+		return result;
+	}
+};
+
+}  // namespace sag
@@ -1,12 +1,14 @@
 #pragma once
 #include <algorithm>
 #include <cassert>
-#include <map>
 #include <memory>
 #include <random>
+#include <span>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "GraphConcepts.h"
+#include "StateDetails.h"
 
 namespace sag {
 
@@ -23,37 +25,31 @@ class DefaultGraphContainer_v1 {
 
 	friend auto operator==(const DefaultGraphContainer_v1&, const DefaultGraphContainer_v1&) -> bool = default;
 
-	[[nodiscard]] auto is_terminal_at(S state) const -> bool { return data_.at(state).empty(); }
+	[[nodiscard]] auto is_terminal_at(S state) const -> bool { return data_.at(state).actions.empty(); }
 	[[nodiscard]] auto is_expanded_at(S state, A action) const -> bool { return edge_count_at(state, action) > 0; }
 	[[nodiscard]] auto roots() const -> std::vector<S> { return roots_; }
-	[[nodiscard]] auto actions_at(S state) const -> std::vector<A> {
-		std::vector<A> result;
-		ActionDetails const& action_details = data_.at(state);
-		result.reserve(action_details.size());
-		for (auto const& entry : action_details) {
-			result.push_back(entry.first);
-		}
-		return result;
-	}
+	[[nodiscard]] auto actions_at(S state) const -> std::vector<A> { return data_.at(state).actions; }
+	[[nodiscard]] auto actions_view_at(S state) const -> std::span<A const> { return data_.at(state).actions; }
 
 	[[nodiscard]] auto edges_at(S state, A action) const -> std::vector<ActionEdge<S>> {
-		return data_.at(state).at(action);
+		return data_.at(state).edges_of(action);
+	}
+	[[nodiscard]] auto edges_view_at(S state, A action) const -> std::span<ActionEdge<S> const> {
+		return data_.at(state).edges_of(action);
 	}
 
-	[[nodiscard]] auto action_count_at(S state) const -> size_t { return data_.at(state).size(); }
+	[[nodiscard]] auto action_count_at(S state) const -> size_t { return data_.at(state).actions.size(); }
 
-	[[nodiscard]] auto edge_count_at(S state, A action) const -> size_t { return data_.at(state).at(action).size(); }
+	[[nodiscard]] auto edge_count_at(S state, A action) const -> size_t {
+		return data_.at(state).edges_of(action).size();
+	}
 
 	auto add(S state, std::vector<A> actions) -> bool;
 
 	auto clear_and_reroot(std::vector<S> new_roots) -> void {
 		std::vector<std::pair<S, std::vector<A>>> root_data;
 		for (S root : new_roots) {
-			std::vector<A> actions;
-			for (auto const& [action, _] : data_[root]) {
-				actions.emplace_back(action);
-			}
-			root_data.emplace_back(root, actions);
+			root_data.emplace_back(root, data_[root].actions);
 		}
 
 		data_.clear();
@@ -63,19 +59,22 @@ class DefaultGraphContainer_v1 {
 		reset_roots_to(root_data);
 	}
 
+	auto retain_and_reroot(std::vector<S> new_roots) -> RerootResult;
+
 	auto expand_at(
 		S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
 		-> bool;
 
+	auto expand_all_at(S state, ActionSuccessors<S, A> successors, std::vector<std::pair<S, std::vector<A>>> next_states)
+		-> size_t;
+
 	[[nodiscard]] auto action_count() const -> size_t { return actions_; }
 	[[nodiscard]] auto state_count() const -> size_t { return data_.size(); }
 	[[nodiscard]] auto edge_count() const -> size_t { return edges_; }
 
  private:
 	std::vector<S> roots_;
-	// listing the actions of a state requires an ordered container
-	using ActionDetails = std::map<A, std::vector<ActionEdge<S>>>;
-	std::unordered_map<S, ActionDetails> data_;
+	std::unordered_map<S, StateDetails<S, A>> data_;
 
 	size_t actions_{0};
 	size_t edges_{0};
@@ -94,43 +93,96 @@ class DefaultGraphContainer_v1 {
 		roots_.reserve(root_data.size());
 		for (auto [root, actions] : root_data) {
 			roots_.push_back(root);
-			ActionDetails action_details{};
-			for (A const action : actions) {
-				// initialize roots as unexpanded
-				action_details[action] = {};
-			}
-			data_[root] = action_details;
+			// initialize roots as unexpanded
+			data_[root] = StateDetails<S, A>(std::move(actions));
 		}
 	}
 };
 
 template <typename S, typename A>
 auto DefaultGraphContainer_v1<S, A>::add(S state, std::vector<A> actions) -> bool {
-	if (data_.try_emplace(state).second) {
-		for (A child_action : actions)
-			data_.at(state).emplace(child_action, std::vector<ActionEdge<S>>());
+	auto [entry, inserted] = data_.try_emplace(state);
+	if (inserted) {
 		actions_ += actions.size();
+		entry->second = StateDetails<S, A>(std::move(actions));
 		return true;
 	}
 	// else return false: state already known/initialised (possibly visited via a different parent, etc.)
-	assert(data_.at(state).size() == actions.size());
+	assert(entry->second.actions.size() == actions.size());
 	return false;
 }
 
+template <typename S, typename A>
+auto DefaultGraphContainer_v1<S, A>::retain_and_reroot(std::vector<S> new_roots) -> RerootResult {
+	// mark all states reachable from the new roots (unknown roots are initialized without actions)
+	std::unordered_set<S> reachable;
+	std::vector<S> pending;
+	for (S root : new_roots) {
+		data_.try_emplace(root);
+		if (reachable.insert(root).second)
+			pending.push_back(root);
+	}
+	while (!pending.empty()) {
+		S const state = pending.back();
+		pending.pop_back();
+		for (auto const& edges : data_.at(state).edges) {
+			for (ActionEdge<S> const& edge : edges) {
+				if (reachable.insert(edge.state()).second)
+					pending.push_back(edge.state());
+			}
+		}
+	}
+
+	// sweep all others and recount
+	size_t const freed =
+		std::erase_if(data_, [&reachable](auto const& entry) { return !reachable.contains(entry.first); });
+	actions_ = 0;
+	edges_ = 0;
+	for (auto const& [state, state_details] : data_) {
+		actions_ += state_details.actions.size();
+		for (auto const& edges : state_details.edges)
+			edges_ += edges.size();
+	}
+
+	roots_ = std::move(new_roots);
+	return {.kept_states = data_.size(), .freed_states = freed};
+}
+
 template <typename S, typename A>
 auto DefaultGraphContainer_v1<S, A>::expand_at(
 	S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
 	-> bool {
-	if (is_expanded_at(state, action))
+	std::vector<ActionEdge<S>>& edges = data_.at(state).edges_of(action);
+	if (!edges.empty())
 		return false;
 
-	data_.at(state).at(action) = new_edges;
 	edges_ += new_edges.size();
+	edges = std::move(new_edges);
 
-	for (const auto& [child, actions] : next_states) {
-		add(child, actions);
+	for (auto& [child, actions] : next_states) {
+		add(child, std::move(actions));
 	}
 	return true;
 }
 
+template <typename S, typename A>
+auto DefaultGraphContainer_v1<S, A>::expand_all_at(
+	S state, ActionSuccessors<S, A> successors, std::vector<std::pair<S, std::vector<A>>> next_states) -> size_t {
+	StateDetails<S, A>& state_details = data_.at(state);
+	size_t expanded = 0;
+	for (auto& [action, new_edges] : successors) {
+		std::vector<ActionEdge<S>>& edges = state_details.edges_of(action);
+		if (!edges.empty())
+			continue;
+		edges_ += new_edges.size();
+		edges = std::move(new_edges);
+		++expanded;
+	}
+
+	for (auto& [child, actions] : next_states) {
+		add(child, std::move(actions));
+	}
+	return expanded;
+}
+
 }  // namespace sag
@@ -0,0 +1,367 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "AliasTable.h"
+#include "GraphConcepts.h"
+
+namespace sag {
+
+/// Flat (cache-friendly) implementation of a state action graph container.
+/// All actions and edges live in shared pools: each state references a contiguous range of (sorted) actions and each
+/// action references a contiguous range of edges (CSR-style). States are located via an open-addressing index.
+/// Each edge range has a parallel alias table, hence 'sample_at' follows an action in constant time.
+template <typename S, typename A>
+class DefaultGraphContainer_v2 {
+ public:
+	template <RulesEngine<S, A> R>
+	explicit DefaultGraphContainer_v2(R const& rules_engine) {
+		reset_roots_to(rules_engine);
+	}
+
+	friend auto operator==(const DefaultGraphContainer_v2& left, const DefaultGraphContainer_v2& right) -> bool {
+		if (left.roots_ != right.roots_ || left.states_.size() != right.states_.size() ||
+				left.edges_.size() != right.edges_.size())
+			return false;
+
+		// compare by content, the pool layout depends on the order of insertion
+		for (Index left_node = 0; left_node < left.states_.size(); ++left_node) {
+			Index const right_node = right.find_node(left.states_[left_node]);
+			if (right_node == no_index)
+				return false;
+			Range const left_actions = left.state_actions_[left_node];
+			Range const right_actions = right.state_actions_[right_node];
+			if (left_actions.count != right_actions.count)
+				return false;
+			for (Index i = 0; i < left_actions.count; ++i) {
+				if (left.actions_[left_actions.begin + i] != right.actions_[right_actions.begin + i] ||
+						!std::ranges::equal(left.edges_of(left_actions.begin + i), right.edges_of(right_actions.begin + i)))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] auto is_terminal_at(S state) const -> bool { return state_actions_[node_of(state)].count == 0; }
+	[[nodiscard]] auto is_expanded_at(S state, A action) const -> bool { return edge_count_at(state, action) > 0; }
+	[[nodiscard]] auto roots() const -> std::vector<S> { return roots_; }
+	[[nodiscard]] auto actions_at(S state) const -> std::vector<A> {
+		auto const view = actions_view_at(state);
+		return {view.begin(), view.end()};
+	}
+	[[nodiscard]] auto actions_view_at(S state) const -> std::span<A const> {
+		Range const range = state_actions_[node_of(state)];
+		return std::span<A const>{actions_}.subspan(range.begin, range.count);
+	}
+
+	[[nodiscard]] auto edges_at(S state, A action) const -> std::vector<ActionEdge<S>> {
+		auto const view = edges_view_at(state, action);
+		return {view.begin(), view.end()};
+	}
+	[[nodiscard]] auto edges_view_at(S state, A action) const -> std::span<ActionEdge<S> const> {
+		return edges_of(position_of(node_of(state), action));
+	}
+
+	/// the successor picked by the roll, same distribution as 'follow' on the edges, but in constant time
+	[[nodiscard]] auto sample_at(S state, A action, tools::UnitValue random_roll) const -> S {
+		Range const range = action_edges_[position_of(node_of(state), action)];
+		if (range.count == 0)
+			throw std::out_of_range("action not expanded at state in graph container");
+		auto const table = std::span<AliasEntry const>{aliases_}.subspan(range.begin, range.count);
+		return edges_[range.begin + sample_alias(table, random_roll)].state();
+	}
+
+	[[nodiscard]] auto action_count_at(S state) const -> size_t { return state_actions_[node_of(state)].count; }
+
+	[[nodiscard]] auto edge_count_at(S state, A action) const -> size_t {
+		return action_edges_[position_of(node_of(state), action)].count;
+	}
+
+	auto add(S state, std::vector<A> actions) -> bool;
+
+	auto clear_and_reroot(std::vector<S> new_roots) -> void {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		root_data.reserve(new_roots.size());
+		for (S root : new_roots) {
+			// unknown roots are (as in DefaultGraphContainer_v1) initialized without actions
+			root_data.emplace_back(root, find_node(root) == no_index ? std::vector<A>{} : actions_at(root));
+		}
+
+		// clear the pools but keep their capacity for the next fill
+		states_.clear();
+		state_actions_.clear();
+		actions_.clear();
+		action_edges_.clear();
+		edges_.clear();
+		aliases_.clear();
+		std::ranges::fill(slots_, no_index);
+
+		reset_roots_to(root_data);
+	}
+
+	auto retain_and_reroot(std::vector<S> new_roots) -> RerootResult;
+
+	auto expand_at(
+		S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+		-> bool;
+
+	auto expand_all_at(S state, ActionSuccessors<S, A> successors, std::vector<std::pair<S, std::vector<A>>> next_states)
+		-> size_t;
+
+	[[nodiscard]] auto action_count() const -> size_t { return actions_.size(); }
+	[[nodiscard]] auto state_count() const -> size_t { return states_.size(); }
+	[[nodiscard]] auto edge_count() const -> size_t { return edges_.size(); }
+
+ private:
+	using Index = std::uint32_t;
+	static constexpr Index no_index = std::numeric_limits<Index>::max();
+	static constexpr size_t initial_slot_count = 64;
+
+	/// a contiguous range inside one of the pools
+	struct Range {
+		Index begin = 0;
+		Index count = 0;
+		friend auto operator<=>(const Range&, const Range&) = default;
+	};
+
+	std::vector<S> roots_;
+
+	// node data, indexed by node id (= insertion order of the states)
+	std::vector<S> states_;
+	std::vector<Range> state_actions_;
+
+	// action pool with a parallel edge range per action, and the edge pool with a parallel alias table pool
+	std::vector<A> actions_;
+	std::vector<Range> action_edges_;
+	std::vector<ActionEdge<S>> edges_;
+	std::vector<AliasEntry> aliases_;
+
+	// open-addressing index (linear probing), a slot holds a node id or 'no_index'. Size is a power of 2.
+	std::vector<Index> slots_ = std::vector<Index>(initial_slot_count, no_index);
+
+	[[nodiscard]] auto home_slot(S const& state) const -> size_t {
+		// fibonacci hashing spreads poorly distributed hashes (e.g. identity for integers) across all slots
+		constexpr std::uint64_t golden_ratio = 0x9E3779B97F4A7C15ULL;
+		auto const shift = static_cast<unsigned>(64 - std::countr_zero(slots_.size()));
+		return (static_cast<std::uint64_t>(std::hash<S>{}(state)) * golden_ratio) >> shift;
+	}
+
+	/// returns the slot holding the state, or else the (free) slot where it would be inserted
+	[[nodiscard]] auto find_slot(S const& state) const -> size_t {
+		size_t const mask = slots_.size() - 1;
+		size_t slot = home_slot(state);
+		while (slots_[slot] != no_index && states_[slots_[slot]] != state)
+			slot = (slot + 1) & mask;
+		return slot;
+	}
+
+	[[nodiscard]] auto find_node(S const& state) const -> Index { return slots_[find_slot(state)]; }
+
+	[[nodiscard]] auto node_of(S const& state) const -> Index {
+		Index const node = find_node(state);
+		if (node == no_index)
+			throw std::out_of_range("state not found in graph container");
+		return node;
+	}
+
+	/// position of the action in the action pool (actions of a state are stored sorted)
+	[[nodiscard]] auto position_of(Index node, A const& action) const -> Index {
+		Range const range = state_actions_[node];
+		auto const first = actions_.begin() + range.begin;
+		auto const last = first + range.count;
+		auto const found = std::lower_bound(first, last, action);
+		if (found == last || *found != action)
+			throw std::out_of_range("action not found at state in graph container");
+		return static_cast<Index>(found - actions_.begin());
+	}
+
+	[[nodiscard]] auto edges_of(Index action_position) const -> std::span<ActionEdge<S> const> {
+		Range const range = action_edges_[action_position];
+		return std::span<ActionEdge<S> const>{edges_}.subspan(range.begin, range.count);
+	}
+
+	auto rehash(size_t slot_count) -> void {
+		slots_.assign(slot_count, no_index);
+		size_t const mask = slots_.size() - 1;
+		for (Index node = 0; node < states_.size(); ++node) {
+			size_t slot = home_slot(states_[node]);
+			while (slots_[slot] != no_index)
+				slot = (slot + 1) & mask;
+			slots_[slot] = node;
+		}
+	}
+
+	template <RulesEngine<S, A> R>
+	auto reset_roots_to(R const& rules) -> void {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		for (S const root : rules.list_roots()) {
+			root_data.emplace_back(root, rules.list_actions(root));
+		}
+		reset_roots_to(root_data);
+	}
+
+	auto reset_roots_to(std::vector<std::pair<S, std::vector<A>>> const& root_data) -> void {
+		roots_.clear();
+		roots_.reserve(root_data.size());
+		for (auto const& [root, actions] : root_data) {
+			roots_.push_back(root);
+			add(root, actions);
+		}
+	}
+};
+
+template <typename S, typename A>
+auto DefaultGraphContainer_v2<S, A>::add(S state, std::vector<A> actions) -> bool {
+	// keep the load factor of the index at most 1/2
+	if (2 * (states_.size() + 1) > slots_.size())
+		rehash(2 * slots_.size());
+
+	size_t const slot = find_slot(state);
+	if (slots_[slot] != no_index) {
+		// state already known/initialised (possibly visited via a different parent, etc.)
+		assert(state_actions_[slots_[slot]].count == actions.size());
+		return false;
+	}
+
+	assert(states_.size() < no_index && actions_.size() + actions.size() < no_index);
+	slots_[slot] = static_cast<Index>(states_.size());
+	states_.push_back(state);
+	state_actions_.push_back({static_cast<Index>(actions_.size()), static_cast<Index>(actions.size())});
+
+	// initialize as unexpanded
+	std::ranges::sort(actions);
+	actions_.insert(actions_.end(), actions.begin(), actions.end());
+	action_edges_.resize(actions_.size());
+	return true;
+}
+
+template <typename S, typename A>
+auto DefaultGraphContainer_v2<S, A>::retain_and_reroot(std::vector<S> new_roots) -> RerootResult {
+	// mark all nodes reachable from the new roots (unknown roots are initialized without actions), in visiting order
+	for (S const& root : new_roots) {
+		if (find_node(root) == no_index)
+			add(root, {});
+	}
+	std::vector<bool> marked(states_.size(), false);
+	std::vector<Index> retained;
+	for (S const& root : new_roots) {
+		Index const node = node_of(root);
+		if (!marked[node]) {
+			marked[node] = true;
+			retained.push_back(node);
+		}
+	}
+	for (size_t head = 0; head < retained.size(); ++head) {
+		Range const actions = state_actions_[retained[head]];
+		for (Index position = actions.begin; position < actions.begin + actions.count; ++position) {
+			Range const edges = action_edges_[position];
+			for (Index edge = edges.begin; edge < edges.begin + edges.count; ++edge) {
+				Index const child = node_of(edges_[edge].state());
+				if (!marked[child]) {
+					marked[child] = true;
+					retained.push_back(child);
+				}
+			}
+		}
+	}
+
+	// sweep by compacting the retained nodes into fresh pools
+	std::vector<S> states;
+	std::vector<Range> state_actions;
+	std::vector<A> actions;
+	std::vector<Range> action_edges;
+	std::vector<ActionEdge<S>> edges;
+	std::vector<AliasEntry> aliases;
+	states.reserve(retained.size());
+	state_actions.reserve(retained.size());
+	for (Index const node : retained) {
+		Range const node_actions = state_actions_[node];
+		states.push_back(states_[node]);
+		state_actions.push_back({static_cast<Index>(actions.size()), node_actions.count});
+		for (Index position = node_actions.begin; position < node_actions.begin + node_actions.count; ++position) {
+			Range const action_range = action_edges_[position];
+			actions.push_back(actions_[position]);
+			action_edges.push_back({action_range.count > 0 ? static_cast<Index>(edges.size()) : 0, action_range.count});
+			edges.insert(edges.end(),
+				edges_.begin() + action_range.begin,
+				edges_.begin() + action_range.begin + action_range.count);
+			aliases.insert(aliases.end(),
+				aliases_.begin() + action_range.begin,
+				aliases_.begin() + action_range.begin + action_range.count);
+		}
+	}
+
+	size_t const freed = states_.size() - retained.size();
+	states_ = std::move(states);
+	state_actions_ = std::move(state_actions);
+	actions_ = std::move(actions);
+	action_edges_ = std::move(action_edges);
+	edges_ = std::move(edges);
+	aliases_ = std::move(aliases);
+	rehash(slots_.size());
+
+	roots_ = std::move(new_roots);
+	return {.kept_states = states_.size(), .freed_states = freed};
+}
+
+template <typename S, typename A>
+auto DefaultGraphContainer_v2<S, A>::expand_at(
+	S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+	-> bool {
+	Index const position = position_of(node_of(state), action);
+	if (action_edges_[position].count > 0)
+		return false;
+
+	assert(edges_.size() + new_edges.size() < no_index);
+	action_edges_[position] = {static_cast<Index>(edges_.size()), static_cast<Index>(new_edges.size())};
+	edges_.insert(edges_.end(), new_edges.begin(), new_edges.end());
+	auto const table = build_alias_table<S>(new_edges);
+	aliases_.insert(aliases_.end(), table.begin(), table.end());
+
+	for (auto& [child, actions] : next_states) {
+		add(child, std::move(actions));
+	}
+	return true;
+}
+
+template <typename S, typename A>
+auto DefaultGraphContainer_v2<S, A>::expand_all_at(
+	S state, ActionSuccessors<S, A> successors, std::vector<std::pair<S, std::vector<A>>> next_states) -> size_t {
+	Index const node = node_of(state);
+	[[maybe_unused]] size_t edge_total = 0;  // only checked by the assertion
+	for (auto const& [action, new_edges] : successors)
+		edge_total += new_edges.size();
+	assert(edges_.size() + edge_total < no_index);
+
+	size_t expanded = 0;
+	for (auto const& [action, new_edges] : successors) {
+		Index const position = position_of(node, action);
+		if (action_edges_[position].count > 0)
+			continue;
+		action_edges_[position] = {static_cast<Index>(edges_.size()), static_cast<Index>(new_edges.size())};
+		edges_.insert(edges_.end(), new_edges.begin(), new_edges.end());
+		auto const table = build_alias_table<S>(new_edges);
+		aliases_.insert(aliases_.end(), table.begin(), table.end());
+		++expanded;
+	}
+
+	// grow the index once for all children
+	size_t slot_count = slots_.size();
+	while (2 * (states_.size() + next_states.size()) > slot_count)
+		slot_count *= 2;
+	if (slot_count != slots_.size())
+		rehash(slot_count);
+	for (auto& [child, actions] : next_states) {
+		add(child, std::move(actions));
+	}
+	return expanded;
+}
+
+}  // namespace sag
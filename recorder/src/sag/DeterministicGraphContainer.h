@@ -0,0 +1,162 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "GraphConcepts.h"
+
+namespace sag {
+
+/// State action graph container for deterministic graphs (see 'DeterministicRulesEngine'): each expanded action
+/// stores its only successor inline, next to the action, without a weight or an edge vector of its own.
+/// The edges are views creating an edge of weight 1 from the stored successor.
+template <typename S, typename A>
+class DeterministicGraphContainer {
+ public:
+	template <RulesEngine<S, A> R>
+	explicit DeterministicGraphContainer(R const& rules_engine) {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		for (S const root : rules_engine.list_roots()) {
+			root_data.emplace_back(root, rules_engine.list_actions(root));
+		}
+		reset_roots_to(root_data);
+	}
+
+	friend auto operator==(const DeterministicGraphContainer&, const DeterministicGraphContainer&) -> bool = default;
+
+	[[nodiscard]] auto is_terminal_at(S state) const -> bool { return data_.at(state).actions.empty(); }
+	[[nodiscard]] auto is_expanded_at(S state, A action) const -> bool {
+		Details const& details = data_.at(state);
+		return details.children[details.index_of(action)].has_value();
+	}
+	[[nodiscard]] auto roots() const -> std::vector<S> { return roots_; }
+	[[nodiscard]] auto actions_at(S state) const -> std::vector<A> { return data_.at(state).actions; }
+	[[nodiscard]] auto actions_view_at(S state) const -> std::span<A const> { return data_.at(state).actions; }
+
+	[[nodiscard]] auto edges_at(S state, A action) const -> std::vector<ActionEdge<S>> {
+		auto const view = edges_view_at(state, action);
+		return {view.begin(), view.end()};
+	}
+	[[nodiscard]] auto edges_view_at(S state, A action) const {
+		Details const& details = data_.at(state);
+		size_t const index = details.index_of(action);
+		// zero or one edge, depending on the expansion
+		auto const child = std::span<std::optional<S> const>{details.children}.subspan(
+			index, static_cast<size_t>(details.children[index].has_value()));
+		return child | std::views::transform([](std::optional<S> const& successor) {
+			return ActionEdge<S>{1.0F, *successor};
+		});
+	}
+
+	/// the successor of an expanded state-action
+	[[nodiscard]] auto child_at(S state, A action) const -> S {
+		Details const& details = data_.at(state);
+		std::optional<S> const& child = details.children[details.index_of(action)];
+		assert(child.has_value());
+		return *child;
+	}
+
+	[[nodiscard]] auto action_count_at(S state) const -> size_t { return data_.at(state).actions.size(); }
+
+	[[nodiscard]] auto edge_count_at(S state, A action) const -> size_t { return is_expanded_at(state, action) ? 1 : 0; }
+
+	auto add(S state, std::vector<A> actions) -> bool;
+
+	auto clear_and_reroot(std::vector<S> new_roots) -> void {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		for (S root : new_roots) {
+			auto const found = data_.find(root);
+			root_data.emplace_back(root, found != data_.end() ? found->second.actions : std::vector<A>{});
+		}
+
+		data_.clear();
+		actions_ = 0;
+		edges_ = 0;
+
+		reset_roots_to(root_data);
+	}
+
+	/// throws std::invalid_argument unless 'new_edges' is a single edge (of weight 1)
+	auto expand_at(
+		S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+		-> bool;
+
+	[[nodiscard]] auto action_count() const -> size_t { return actions_; }
+	[[nodiscard]] auto state_count() const -> size_t { return data_.size(); }
+	[[nodiscard]] auto edge_count() const -> size_t { return edges_; }
+
+ private:
+	/// the (sorted) actions of a state, each with its - possibly not yet expanded - successor at the same index
+	struct Details {
+		std::vector<A> actions;
+		std::vector<std::optional<S>> children;
+
+		friend auto operator==(const Details&, const Details&) -> bool = default;
+
+		[[nodiscard]] auto index_of(A const& action) const -> size_t {
+			auto const found = std::ranges::lower_bound(actions, action);
+			if (found == actions.end() || *found != action)
+				throw std::out_of_range("action not found at state in graph container");
+			return static_cast<size_t>(found - actions.begin());
+		}
+	};
+
+	std::vector<S> roots_;
+	std::unordered_map<S, Details> data_;
+
+	size_t actions_{0};
+	size_t edges_{0};
+
+	auto reset_roots_to(std::vector<std::pair<S, std::vector<A>>> const& root_data) -> void {
+		roots_.clear();
+		roots_.reserve(root_data.size());
+		for (auto const& [root, actions] : root_data) {
+			roots_.push_back(root);
+			// initialize roots as unexpanded
+			add(root, actions);
+		}
+	}
+};
+
+template <typename S, typename A>
+auto DeterministicGraphContainer<S, A>::add(S state, std::vector<A> actions) -> bool {
+	auto [entry, inserted] = data_.try_emplace(state);
+	if (inserted) {
+		Details& details = entry->second;
+		std::ranges::sort(actions);
+		details.actions = std::move(actions);
+		details.children.resize(details.actions.size());
+		actions_ += details.actions.size();
+		return true;
+	}
+	// else return false: state already known/initialised (possibly visited via a different parent, etc.)
+	assert(entry->second.actions.size() == actions.size());
+	return false;
+}
+
+template <typename S, typename A>
+auto DeterministicGraphContainer<S, A>::expand_at(
+	S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+	-> bool {
+	if (new_edges.size() != 1)
+		throw std::invalid_argument("deterministic graph container requires a single edge per action");
+
+	Details& details = data_.at(state);
+	std::optional<S>& child = details.children[details.index_of(action)];
+	if (child.has_value())
+		return false;
+
+	child = new_edges.front().state();
+	++edges_;
+	for (auto& [next_state, actions] : next_states) {
+		add(next_state, std::move(actions));
+	}
+	return true;
+}
+
+}  // namespace sag
@@ -0,0 +1,226 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "GraphConcepts.h"
+#include "StateDetails.h"
+
+namespace sag {
+
+/// State action graph container which resets in constant time: 'clear_and_reroot' bumps an epoch counter, and all
+/// entries of older epochs count as absent. Such a stale entry is reused in place by the next insert into its slot,
+/// including the capacity of its action and edge vectors, hence the memory of the last turn stays warm for the next.
+/// The table is compacted (stale memory released, slots shrunk) at a reroot only if the ending epoch used less than
+/// 'compaction_threshold' of the slots, e.g. towards the end of a match.
+template <typename S, typename A>
+class EpochGraphContainer {
+ public:
+	using Epoch = std::uint32_t;
+	static constexpr double compaction_threshold = 1.0 / 16;
+	static constexpr size_t initial_slot_count = 64;
+
+	template <RulesEngine<S, A> R>
+	explicit EpochGraphContainer(R const& rules_engine) {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		for (S const root : rules_engine.list_roots()) {
+			root_data.emplace_back(root, rules_engine.list_actions(root));
+		}
+		reset_roots_to(std::move(root_data));
+	}
+
+	/// compares the entries of the current epochs only
+	friend auto operator==(const EpochGraphContainer& left, const EpochGraphContainer& right) -> bool {
+		if (left.roots_ != right.roots_ || left.states_ != right.states_ || left.edges_ != right.edges_)
+			return false;
+		return std::ranges::all_of(left.slots_, [&](Slot const& slot) {
+			if (slot.epoch != left.epoch_)
+				return true;
+			Slot const& other = right.slots_[right.find_slot(slot.state)];
+			return other.epoch == right.epoch_ && other.details == slot.details;
+		});
+	}
+
+	[[nodiscard]] auto is_terminal_at(S state) const -> bool { return details_of(state).actions.empty(); }
+	[[nodiscard]] auto is_expanded_at(S state, A action) const -> bool { return edge_count_at(state, action) > 0; }
+	[[nodiscard]] auto roots() const -> std::vector<S> { return roots_; }
+	[[nodiscard]] auto actions_at(S state) const -> std::vector<A> { return details_of(state).actions; }
+	[[nodiscard]] auto actions_view_at(S state) const -> std::span<A const> { return details_of(state).actions; }
+
+	[[nodiscard]] auto edges_at(S state, A action) const -> std::vector<ActionEdge<S>> {
+		return details_of(state).edges_of(action);
+	}
+	[[nodiscard]] auto edges_view_at(S state, A action) const -> std::span<ActionEdge<S> const> {
+		return details_of(state).edges_of(action);
+	}
+
+	[[nodiscard]] auto action_count_at(S state) const -> size_t { return details_of(state).actions.size(); }
+
+	[[nodiscard]] auto edge_count_at(S state, A action) const -> size_t {
+		return details_of(state).edges_of(action).size();
+	}
+
+	auto add(S state, std::vector<A> actions) -> bool;
+
+	/// constant time, unless the table gets compacted
+	auto clear_and_reroot(std::vector<S> new_roots) -> void {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		root_data.reserve(new_roots.size());
+		for (S root : new_roots) {
+			// unknown roots are (as in DefaultGraphContainer_v1) initialized without actions
+			Slot const& slot = slots_[find_slot(root)];
+			root_data.emplace_back(root, slot.epoch == epoch_ ? slot.details.actions : std::vector<A>{});
+		}
+
+		if (static_cast<double>(states_) < compaction_threshold * static_cast<double>(slots_.size()) &&
+				slots_.size() > initial_slot_count) {
+			compact();
+		}
+		next_epoch();
+		reset_roots_to(std::move(root_data));
+	}
+
+	auto expand_at(
+		S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+		-> bool;
+
+	[[nodiscard]] auto action_count() const -> size_t { return actions_; }
+	[[nodiscard]] auto state_count() const -> size_t { return states_; }
+	[[nodiscard]] auto edge_count() const -> size_t { return edges_; }
+
+	[[nodiscard]] auto epoch() const -> Epoch { return epoch_; }
+	[[nodiscard]] auto slot_count() const -> size_t { return slots_.size(); }
+	[[nodiscard]] auto compaction_count() const -> size_t { return compactions_; }
+
+ private:
+	/// a slot is occupied iff its epoch is the current one, else its memory is kept for reuse
+	struct Slot {
+		S state{};
+		Epoch epoch = 0;
+		StateDetails<S, A> details;
+	};
+
+	std::vector<S> roots_;
+	std::vector<Slot> slots_ = std::vector<Slot>(initial_slot_count);  // open addressing, size is a power of 2
+	Epoch epoch_ = 1;
+
+	size_t states_{0};
+	size_t actions_{0};
+	size_t edges_{0};
+	size_t compactions_{0};
+
+	/// returns the slot holding the state, or else the (unoccupied) slot where it would be inserted
+	[[nodiscard]] auto find_slot(S const& state) const -> size_t {
+		// fibonacci hashing spreads poorly distributed hashes (e.g. identity for integers) across all slots
+		constexpr std::uint64_t golden_ratio = 0x9E3779B97F4A7C15ULL;
+		auto const shift = static_cast<unsigned>(64 - std::countr_zero(slots_.size()));
+		size_t const mask = slots_.size() - 1;
+		size_t slot = (static_cast<std::uint64_t>(std::hash<S>{}(state)) * golden_ratio) >> shift;
+		while (slots_[slot].epoch == epoch_ && slots_[slot].state != state)
+			slot = (slot + 1) & mask;
+		return slot;
+	}
+
+	[[nodiscard]] auto details_of(S const& state) const -> StateDetails<S, A> const& {
+		Slot const& slot = slots_[find_slot(state)];
+		if (slot.epoch != epoch_)
+			throw std::out_of_range("state not found in graph container");
+		return slot.details;
+	}
+	[[nodiscard]] auto details_of(S const& state) -> StateDetails<S, A>& {
+		return const_cast<StateDetails<S, A>&>(std::as_const(*this).details_of(state));
+	}
+
+	/// moves the entries of the current epoch into a table of the given size, drops the stale ones
+	auto rehash(size_t slot_count) -> void {
+		std::vector<Slot> old_slots = std::exchange(slots_, std::vector<Slot>(slot_count));
+		for (Slot& slot : old_slots) {
+			if (slot.epoch == epoch_)
+				slots_[find_slot(slot.state)] = std::move(slot);
+		}
+	}
+
+	/// releases the stale memory: the next epoch starts on a table fitting the ending one
+	auto compact() -> void {
+		slots_ = std::vector<Slot>(std::max(initial_slot_count, std::bit_ceil(4 * states_)));
+		++compactions_;
+	}
+
+	auto next_epoch() -> void {
+		if (++epoch_ == 0) {
+			// wrapped around (after 2^32 reroots): mark all slots as never used
+			for (Slot& slot : slots_)
+				slot.epoch = 0;
+			epoch_ = 1;
+		}
+		states_ = 0;
+		actions_ = 0;
+		edges_ = 0;
+	}
+
+	auto reset_roots_to(std::vector<std::pair<S, std::vector<A>>> root_data) -> void {
+		roots_.clear();
+		roots_.reserve(root_data.size());
+		for (auto& [root, actions] : root_data) {
+			roots_.push_back(root);
+			// initialize roots as unexpanded
+			add(root, std::move(actions));
+		}
+	}
+};
+
+template <typename S, typename A>
+auto EpochGraphContainer<S, A>::add(S state, std::vector<A> actions) -> bool {
+	// keep the load factor at most 1/2
+	if (2 * (states_ + 1) > slots_.size())
+		rehash(2 * slots_.size());
+
+	Slot& slot = slots_[find_slot(state)];
+	if (slot.epoch == epoch_) {
+		// state already known/initialised (possibly visited via a different parent, etc.)
+		assert(slot.details.actions.size() == actions.size());
+		return false;
+	}
+
+	// reuse the slot (and the capacity of its vectors) in place
+	slot.state = state;
+	slot.epoch = epoch_;
+	std::ranges::sort(actions);
+	StateDetails<S, A>& details = slot.details;
+	details.actions.assign(actions.begin(), actions.end());
+	for (size_t index = 0; index < std::min(details.edges.size(), actions.size()); ++index)
+		details.edges[index].clear();
+	details.edges.resize(actions.size());
+
+	++states_;
+	actions_ += actions.size();
+	return true;
+}
+
+template <typename S, typename A>
+auto EpochGraphContainer<S, A>::expand_at(
+	S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+	-> bool {
+	std::vector<ActionEdge<S>>& edges = details_of(state).edges_of(action);
+	if (!edges.empty())
+		return false;
+
+	edges_ += new_edges.size();
+	if (edges.capacity() >= new_edges.size())
+		edges.assign(new_edges.begin(), new_edges.end());  // warm memory of an earlier epoch
+	else
+		edges = std::move(new_edges);
+
+	for (auto& [child, actions] : next_states) {
+		add(child, std::move(actions));
+	}
+	return true;
+}
+
+}  // namespace sag
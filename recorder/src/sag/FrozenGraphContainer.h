@@ -0,0 +1,430 @@
+#pragma once
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "GraphConcepts.h"
+#include "GraphOperations.h"
+#include "tools/MappedFile.h"
+
+namespace sag {
+
+/// States and actions that can be stored in a frozen graph file: copied bytewise, and the actions of a state sorted
+template <typename S, typename A>
+concept FreezableVertices =
+	Vertices<S, A> && std::totally_ordered<A> && std::is_trivially_copyable_v<S> && std::is_trivially_copyable_v<A>;
+
+/// Header of a frozen graph file. The sections follow in the order of 'FrozenGraphLayout', each aligned to 16 bytes:
+/// roots (node ids), states, offsets of the actions of each state, actions (sorted per state), offsets of the edges of
+/// each action, edges and the open addressing index of the states (node ids).
+struct FrozenGraphHeader {
+	static constexpr std::uint64_t file_magic = 0x3230525343474153;  // "SAGCSR02"
+
+	std::uint64_t magic = file_magic;
+	std::uint32_t state_size = 0;
+	std::uint32_t action_size = 0;
+	std::uint64_t hash_check = 0;  // std::hash of the first root, as the index is only valid for the same hash
+	std::uint64_t root_count = 0;
+	std::uint64_t state_count = 0;
+	std::uint64_t action_count = 0;
+	std::uint64_t edge_count = 0;
+	std::uint64_t slot_count = 0;
+};
+
+/// Edge of a frozen graph, referring to the successor by its node id (stored bytewise as well)
+using FrozenEdge = ActionEdge<NodeId>;
+static_assert(std::is_trivially_copy_constructible_v<FrozenEdge> && std::is_trivially_destructible_v<FrozenEdge>);
+
+/// Byte offsets of the sections of a frozen graph file
+struct FrozenGraphLayout {
+	using Offset = std::uint64_t;
+	static constexpr NodeId no_node = std::numeric_limits<NodeId>::max();
+	static constexpr size_t alignment = 16;
+
+	size_t roots;
+	size_t states;
+	size_t state_actions;
+	size_t actions;
+	size_t action_edges;
+	size_t edges;
+	size_t slots;
+	size_t size;
+
+	template <typename S, typename A>
+	static auto of(FrozenGraphHeader const& header) -> FrozenGraphLayout {
+		size_t end = sizeof(FrozenGraphHeader);
+		auto next = [&end](size_t count, size_t element_size) {
+			size_t const begin = (end + alignment - 1) / alignment * alignment;
+			end = begin + count * element_size;
+			return begin;
+		};
+		FrozenGraphLayout layout{};
+		layout.roots = next(header.root_count, sizeof(NodeId));
+		layout.states = next(header.state_count, sizeof(S));
+		layout.state_actions = next(header.state_count + 1, sizeof(Offset));
+		layout.actions = next(header.action_count, sizeof(A));
+		layout.action_edges = next(header.action_count + 1, sizeof(Offset));
+		layout.edges = next(header.edge_count, sizeof(FrozenEdge));
+		layout.slots = next(header.slot_count, sizeof(NodeId));
+		layout.size = end;
+		return layout;
+	}
+
+	/// home slot of the index (fibonacci hashing, the slot count is a power of 2)
+	static auto home_slot(size_t hash, size_t slot_count) -> size_t {
+		constexpr std::uint64_t golden_ratio = 0x9E3779B97F4A7C15ULL;
+		auto const shift = static_cast<unsigned>(64 - std::countr_zero(slot_count));
+		return (std::uint64_t{hash} * golden_ratio) >> shift;
+	}
+};
+
+/// Read-only state action graph container over a frozen graph file (see 'freeze_graph'), holding all reachable states
+/// with all actions expanded. The file is memory mapped and used in place: no parsing at startup, and all copies of
+/// the container (e.g. of parallel match recorders) share one physical copy. Expanding or adding known states is a
+/// no-op, unknown states throw. Rerooting only replaces the roots.
+template <typename S, typename A>
+	requires FreezableVertices<S, A>
+class FrozenGraphContainer {
+	using Offset = FrozenGraphLayout::Offset;
+
+ public:
+	/// empty graph, without roots
+	FrozenGraphContainer() = default;
+
+	/// throws std::runtime_error if the file is not a frozen graph of these states and actions
+	explicit FrozenGraphContainer(std::filesystem::path const& path);
+
+	/// same roots, same graph (if not the same mapping, then the same file contents)
+	friend auto operator==(const FrozenGraphContainer& left, const FrozenGraphContainer& right) -> bool {
+		if (left.roots_ != right.roots_)
+			return false;
+		if (left.file_ == right.file_)
+			return true;
+		return std::ranges::equal(left.file_bytes(), right.file_bytes());
+	}
+
+	[[nodiscard]] auto is_terminal_at(S state) const -> bool { return node_actions(node_of(state)).empty(); }
+	[[nodiscard]] auto is_expanded_at(S state, A action) const -> bool { return edge_count_at(state, action) > 0; }
+	[[nodiscard]] auto roots() const -> std::vector<S> { return roots_; }
+	[[nodiscard]] auto actions_at(S state) const -> std::vector<A> {
+		auto const view = actions_view_at(state);
+		return {view.begin(), view.end()};
+	}
+	[[nodiscard]] auto actions_view_at(S state) const -> std::span<A const> { return node_actions(node_of(state)); }
+
+	[[nodiscard]] auto edges_at(S state, A action) const -> std::vector<ActionEdge<S>> {
+		auto const view = edges_view_at(state, action);
+		return {view.begin(), view.end()};
+	}
+	[[nodiscard]] auto edges_view_at(S state, A action) const {
+		return frozen_edges(position_of(node_of(state), action)) | std::views::transform([this](FrozenEdge const& edge) {
+			return ActionEdge<S>{edge.weight().value(), states_[edge.state()]};
+		});
+	}
+
+	[[nodiscard]] auto action_count_at(S state) const -> size_t { return node_actions(node_of(state)).size(); }
+	[[nodiscard]] auto edge_count_at(S state, A action) const -> size_t {
+		return frozen_edges(position_of(node_of(state), action)).size();
+	}
+
+	/// the graph is complete: returns false for known states, throws for unknown ones
+	auto add(S state, std::vector<A> /*actions*/) -> bool {
+		static_cast<void>(node_of(state));
+		return false;
+	}
+
+	/// the graph is complete: returns false for known states, throws for unknown ones
+	auto expand_at(S state,
+		A action,
+		std::vector<ActionEdge<S>> /*new_edges*/,
+		std::vector<std::pair<S, std::vector<A>>> /*next_states*/) -> bool {
+		static_cast<void>(position_of(node_of(state), action));
+		return false;
+	}
+
+	auto clear_and_reroot(std::vector<S> new_roots) -> void {
+		for (S const& root : new_roots)
+			static_cast<void>(node_of(root));
+		roots_ = std::move(new_roots);
+	}
+
+	[[nodiscard]] auto action_count() const -> size_t { return actions_.size(); }
+	[[nodiscard]] auto state_count() const -> size_t { return states_.size(); }
+	[[nodiscard]] auto edge_count() const -> size_t { return edges_.size(); }
+
+	/// concept NodeIndexedGraphContainer: the node id is the index of the state in the file
+	[[nodiscard]] auto node_of(S const& state) const -> NodeId {
+		if (!slots_.empty()) {
+			size_t const mask = slots_.size() - 1;
+			for (size_t slot = FrozenGraphLayout::home_slot(std::hash<S>{}(state), slots_.size());
+					 slots_[slot] != FrozenGraphLayout::no_node;
+					 slot = (slot + 1) & mask) {
+				if (states_[slots_[slot]] == state)
+					return slots_[slot];
+			}
+		}
+		throw std::out_of_range("state not found in graph container");
+	}
+	[[nodiscard]] auto state_of(NodeId node) const -> S { return states_[node]; }
+	[[nodiscard]] auto node_count() const -> size_t { return states_.size(); }
+	[[nodiscard]] auto node_actions(NodeId node) const -> std::span<A const> {
+		return actions_.subspan(state_actions_[node], state_actions_[node + 1] - state_actions_[node]);
+	}
+	[[nodiscard]] auto node_edges(NodeId node, size_t action_index) const -> std::span<FrozenEdge const> {
+		return frozen_edges(state_actions_[node] + action_index);
+	}
+
+ private:
+	std::shared_ptr<tools::MappedFile const> file_;
+	std::vector<S> roots_;
+
+	// sections of the mapped file
+	std::span<S const> states_;
+	std::span<Offset const> state_actions_;
+	std::span<A const> actions_;
+	std::span<Offset const> action_edges_;
+	std::span<FrozenEdge const> edges_;
+	std::span<NodeId const> slots_;
+
+	[[nodiscard]] auto file_bytes() const -> std::span<std::byte const> {
+		return file_ ? file_->bytes() : std::span<std::byte const>{};
+	}
+
+	/// position of the action in the action section (actions of a state are stored sorted)
+	[[nodiscard]] auto position_of(NodeId node, A const& action) const -> size_t {
+		auto const actions = node_actions(node);
+		auto const found = std::ranges::lower_bound(actions, action);
+		if (found == actions.end() || *found != action)
+			throw std::out_of_range("action not found at state in graph container");
+		return state_actions_[node] + static_cast<size_t>(found - actions.begin());
+	}
+
+	[[nodiscard]] auto frozen_edges(size_t position) const -> std::span<FrozenEdge const> {
+		return edges_.subspan(action_edges_[position], action_edges_[position + 1] - action_edges_[position]);
+	}
+
+	template <typename T>
+	[[nodiscard]] static auto section(std::span<std::byte const> bytes, size_t offset, size_t count)
+		-> std::span<T const> {
+		// the mapping is page aligned and the sections are aligned to 16 bytes, the bytes implicitly hold the objects
+		return {reinterpret_cast<T const*>(bytes.data() + offset), count};  // NOLINT(*reinterpret-cast)
+	}
+};
+
+template <typename S, typename A>
+	requires FreezableVertices<S, A>
+FrozenGraphContainer<S, A>::FrozenGraphContainer(std::filesystem::path const& path)
+		: file_(std::make_shared<tools::MappedFile const>(path)) {
+	std::span<std::byte const> const bytes = file_->bytes();
+	FrozenGraphHeader header;
+	if (bytes.size() < sizeof(header))
+		throw std::runtime_error(fmt::format("'{}' is not a frozen graph file", path.string()));
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	if (header.magic != FrozenGraphHeader::file_magic)
+		throw std::runtime_error(fmt::format("'{}' is not a frozen graph file", path.string()));
+	if (header.state_size != sizeof(S) || header.action_size != sizeof(A))
+		throw std::runtime_error(fmt::format("'{}' holds a graph of different states or actions", path.string()));
+	FrozenGraphLayout const layout = FrozenGraphLayout::of<S, A>(header);
+	if (layout.size != bytes.size())
+		throw std::runtime_error(fmt::format("'{}' is truncated or corrupt", path.string()));
+
+	auto const roots = section<NodeId>(bytes, layout.roots, header.root_count);
+	states_ = section<S>(bytes, layout.states, header.state_count);
+	state_actions_ = section<Offset>(bytes, layout.state_actions, header.state_count + 1);
+	actions_ = section<A>(bytes, layout.actions, header.action_count);
+	action_edges_ = section<Offset>(bytes, layout.action_edges, header.action_count + 1);
+	edges_ = section<FrozenEdge>(bytes, layout.edges, header.edge_count);
+	slots_ = section<NodeId>(bytes, layout.slots, header.slot_count);
+
+	if (!roots.empty() && std::hash<S>{}(states_[roots.front()]) != header.hash_check)
+		throw std::runtime_error(fmt::format("'{}' was indexed with a different state hash", path.string()));
+	std::ranges::transform(roots, std::back_inserter(roots_), [this](NodeId root) { return states_[root]; });
+}
+
+/// Buffered writer of one section of a frozen graph file, such that several sections can be written interleaved
+template <typename T>
+class FrozenSectionWriter {
+ public:
+	static constexpr size_t buffer_size = size_t{1} << 16;
+
+	FrozenSectionWriter(std::ofstream& file, size_t offset) : file_(&file), offset_(offset) {
+		buffer_.reserve(buffer_size);
+	}
+
+	auto push_back(T const& value) -> void {
+		buffer_.push_back(value);
+		if (buffer_.size() == buffer_size)
+			flush();
+	}
+
+	auto flush() -> void {
+		file_->seekp(static_cast<std::streamoff>(offset_));
+		file_->write(reinterpret_cast<char const*>(buffer_.data()),  // NOLINT(*reinterpret-cast)
+			static_cast<std::streamsize>(buffer_.size() * sizeof(T)));
+		offset_ += buffer_.size() * sizeof(T);
+		buffer_.clear();
+	}
+
+ private:
+	std::ofstream* file_;
+	size_t offset_;
+	std::vector<T> buffer_;
+};
+
+/// Enumerates all states reachable from the roots of the rules engine, with all their actions and edges, and writes
+/// the complete graph to a frozen graph file (see 'FrozenGraphContainer'). Returns the header of the written file.
+/// Only the states are held in memory, as one vector sorted by hash (node ids are the positions in it): the states are
+/// discovered breadth first and deduplicated by sorting by hash and comparing those of equal hashes, the actions and
+/// edges are generated again and streamed to the file. Throws std::length_error if there are too many states for node
+/// ids, and std::runtime_error if the file cannot be written.
+template <typename S, typename A, RulesEngine<S, A> R>
+	requires FreezableVertices<S, A>
+auto freeze_graph(R const& rules, std::filesystem::path const& path) -> FrozenGraphHeader {
+	using Offset = FrozenGraphLayout::Offset;
+	constexpr size_t chunk_size = size_t{1} << 22;  // successors sorted at once, bounds the memory of each level
+
+	// the states need no order, vectors of states are sorted by hash and searched by equality among equal hashes
+	auto hash_of = [](S const& state) -> size_t { return std::hash<S>{}(state); };
+	auto by_hash = [&hash_of](S const& left, S const& right) { return hash_of(left) < hash_of(right); };
+	auto find_in = [&by_hash](std::vector<S> const& sorted, S const& state) {
+		auto const [first, last] = std::ranges::equal_range(sorted, state, by_hash);
+		auto const found = std::find(first, last, state);
+		return found != last ? found : sorted.end();
+	};
+	// sorted and unique 'values' without those in sorted 'known'
+	auto new_states = [&](std::vector<S>& values, std::vector<S> const& known) {
+		std::ranges::sort(values, by_hash);
+		auto kept = values.begin();
+		auto same_hash = values.begin();  // first kept state of the hash of the current one
+		for (auto current = values.begin(); current != values.end(); ++current) {
+			if (kept == values.begin() || hash_of(*std::prev(kept)) != hash_of(*current))
+				same_hash = kept;
+			if (std::find(same_hash, kept, *current) == kept && find_in(known, *current) == known.end())
+				*kept++ = *current;
+		}
+		values.erase(kept, values.end());
+	};
+	// merges sorted 'values' into sorted 'target'
+	auto merge_into = [&by_hash](std::vector<S>& target, std::vector<S> const& values) {
+		auto const middle = static_cast<std::ptrdiff_t>(target.size());
+		target.insert(target.end(), values.begin(), values.end());
+		std::inplace_merge(target.begin(), target.begin() + middle, target.end(), by_hash);
+	};
+
+	// discover the states level by level, counting actions and edges on the way
+	std::vector<S> const root_states = rules.list_roots();
+	std::vector<S> states = root_states;
+	new_states(states, {});
+	std::vector<S> frontier = states;
+	size_t action_count = 0;
+	size_t edge_count = 0;
+	while (!frontier.empty()) {
+		std::vector<S> level;
+		std::vector<S> successors;
+		auto add_successors = [&]() {
+			new_states(successors, states);
+			std::erase_if(successors, [&](S const& state) { return find_in(level, state) != level.end(); });
+			merge_into(level, successors);
+			successors.clear();
+		};
+		for (S const& state : frontier) {
+			for (A const& action : list_actions<S, A>(rules, state)) {
+				++action_count;
+				for (ActionEdge<S> const& edge : list_edges<S, A>(rules, state, action)) {
+					++edge_count;
+					successors.push_back(edge.state());
+				}
+			}
+			if (successors.size() >= chunk_size)
+				add_successors();
+		}
+		add_successors();
+		merge_into(states, level);
+		frontier = std::move(level);
+	}
+	if (states.size() >= std::numeric_limits<NodeId>::max())
+		throw std::length_error("graph too large to be frozen");
+	auto node_of = [&](S const& state) { return static_cast<NodeId>(find_in(states, state) - states.begin()); };
+
+	std::vector<NodeId> roots;
+	std::ranges::transform(root_states, std::back_inserter(roots), node_of);
+	// index with load factor at most 1/2
+	std::vector<NodeId> slots(std::max(size_t{2}, std::bit_ceil(2 * states.size())), FrozenGraphLayout::no_node);
+	for (NodeId node = 0; node < states.size(); ++node) {
+		size_t slot = FrozenGraphLayout::home_slot(hash_of(states[node]), slots.size());
+		while (slots[slot] != FrozenGraphLayout::no_node)
+			slot = (slot + 1) & (slots.size() - 1);
+		slots[slot] = node;
+	}
+
+	FrozenGraphHeader header{.magic = FrozenGraphHeader::file_magic,
+		.state_size = sizeof(S),
+		.action_size = sizeof(A),
+		.hash_check = roots.empty() ? 0 : hash_of(states[roots.front()]),
+		.root_count = roots.size(),
+		.state_count = states.size(),
+		.action_count = action_count,
+		.edge_count = edge_count,
+		.slot_count = slots.size()};
+	FrozenGraphLayout const layout = FrozenGraphLayout::of<S, A>(header);
+
+	// the trailing (zero) padding bytes of a section are filled by the next one
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	auto write_at = [&file](size_t offset, void const* data, size_t size) {
+		file.seekp(static_cast<std::streamoff>(offset));
+		file.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+	};
+	write_at(0, &header, sizeof(header));
+	write_at(layout.roots, roots.data(), roots.size() * sizeof(NodeId));
+	write_at(layout.states, states.data(), states.size() * sizeof(S));
+	write_at(layout.slots, slots.data(), slots.size() * sizeof(NodeId));
+	slots = {};
+
+	// the actions and edges in node order
+	FrozenSectionWriter<Offset> state_actions(file, layout.state_actions);
+	FrozenSectionWriter<A> actions(file, layout.actions);
+	FrozenSectionWriter<Offset> action_edges(file, layout.action_edges);
+	FrozenSectionWriter<FrozenEdge> edges(file, layout.edges);
+	Offset action_offset = 0;
+	Offset edge_offset = 0;
+	state_actions.push_back(action_offset);
+	action_edges.push_back(edge_offset);
+	for (S const& state : states) {
+		std::vector<A> state_action_list = list_actions<S, A>(rules, state);
+		std::ranges::sort(state_action_list);
+		for (A const& action : state_action_list) {
+			actions.push_back(action);
+			for (ActionEdge<S> const& edge : list_edges<S, A>(rules, state, action)) {
+				edges.push_back(FrozenEdge(edge.weight().value(), node_of(edge.state())));
+				++edge_offset;
+			}
+			action_edges.push_back(edge_offset);
+		}
+		action_offset += state_action_list.size();
+		state_actions.push_back(action_offset);
+	}
+	state_actions.flush();
+	actions.flush();
+	action_edges.flush();
+	edges.flush();
+	file.close();
+	if (!file || std::filesystem::file_size(path) != layout.size)
+		throw std::runtime_error(fmt::format("could not write frozen graph file '{}'", path.string()));
+	return header;
+}
+
+}  // namespace sag
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <concepts>
+#include <cstdint>
+#include <ranges>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -51,6 +54,14 @@ template <typename StateId, typename ActionId>
 /// it is only required to be unique among the actions of each individual state
 concept Vertices = Identifier<StateId> && Identifier<ActionId>;
 
+template <typename R, typename T>
+/// A sized random access range of elements convertible to T, typically a (borrowed) view like std::span<T const>.
+concept ViewOf = std::ranges::random_access_range<R> && std::ranges::sized_range<R> &&
+	std::convertible_to<std::ranges::range_reference_t<R>, T>;
+
+static_assert(ViewOf<std::span<int const>, int>);
+static_assert(ViewOf<std::vector<int>, int>);
+
 /// Wrapper around std::pair, representing an edge weight with the successor state
 template <Identifier State>
 class ActionEdge{
@@ -72,6 +83,15 @@ static_assert(std::regular<ActionEdge<int>>);
 static_assert(std::regular<ActionEdge<double>>);
 static_assert(std::regular<ActionEdge<std::string>>);
 
+/// The actions of a state, each with its leaving edges
+template <typename S, typename A>
+using ActionSuccessors = std::vector<std::pair<A, std::vector<ActionEdge<S>>>>;
+
+/// Dense id of a state inside a graph container (see 'NodeIndexedGraphContainer')
+using NodeId = std::uint32_t;
+
+static_assert(sizeof(ActionEdge<NodeId>) == 8);
+
 // --------------------------------------------------------------------------------------------------------------------
 // Main graph concepts
 // --------------------------------------------------------------------------------------------------------------------
@@ -85,6 +105,10 @@ template <typename G, typename S, typename A>
 /// - 'edges_at' for a non-expanded state-action returns emtpy.
 /// - 'expand_at' for an expanded state-action a no-op which returns false.
 /// - 'expand_at' returns false iff the graph failed to add the new edges and next states to itself.
+/// - 'actions_view_at' and 'edges_view_at' list the same as 'actions_at' and 'edges_at', but without copying: they
+/// borrow from the container and are invalidated by any non-const operation.
+/// - 'expand_at' and 'add' take their vectors as sinks: callers move them in, and containers move them into their
+/// storage (instead of copying) wherever the storage layout allows.
 concept GraphContainer = Vertices<S, A> && std::regular<G> && requires(G graph,
 	G const const_graph,
 	S state,
@@ -100,13 +124,15 @@ concept GraphContainer = Vertices<S, A> && std::regular<G> && requires(G graph,
 	{ const_graph.roots() } -> std::same_as<std::vector<S>>;
 	{ const_graph.actions_at(state) } -> std::same_as<std::vector<A>>;
 	{ const_graph.edges_at(state, action) } -> std::same_as<std::vector<ActionEdge<S>>>;
+	{ const_graph.actions_view_at(state) } -> ViewOf<A>;
+	{ const_graph.edges_view_at(state, action) } -> ViewOf<ActionEdge<S>>;
 	{ const_graph.action_count_at(state) } -> std::same_as<size_t>;
 	{ const_graph.edge_count_at(state, action) } -> std::same_as<size_t>;
 
 	// non-const operations
-	{ graph.expand_at(state, action, new_edges, next_states) } -> std::same_as<bool>;
-	{ graph.add(state, actions) } -> std::same_as<bool>;
-	{ graph.clear_and_reroot(new_roots) } -> std::same_as<void>;
+	{ graph.expand_at(state, action, std::move(new_edges), std::move(next_states)) } -> std::same_as<bool>;
+	{ graph.add(state, std::move(actions)) } -> std::same_as<bool>;
+	{ graph.clear_and_reroot(std::move(new_roots)) } -> std::same_as<void>;
 };
 
 template <typename R, typename S, typename A>
@@ -133,6 +159,158 @@ concept CountingGraphContainer = GraphContainer<G, S, A> && requires(G const con
 	{ const_graph.edge_count() } -> std::same_as<size_t>;
 };
 
+template <typename G, typename S, typename A>
+/// A graph container that may be shared across threads, e.g. by several search threads on one tree.
+/// REQUIREMENTS:
+/// - 'G::is_concurrent' is a constant expression evaluating to true.
+/// - all operations may be called concurrently
+/// - concurrent 'expand_at' calls for the same state-action expand it exactly once (only one of them returns true).
+/// - any state reached through the edges of an expanded state-action is known to the container.
+concept ConcurrentGraphContainer = GraphContainer<G, S, A> && requires {
+	requires G::is_concurrent;
+};
+
+/// Outcome of rerooting a graph container while retaining the subgraph reachable from the new roots.
+struct RerootResult {
+	size_t kept_states = 0;
+	size_t freed_states = 0;
+
+	friend auto operator<=>(const RerootResult&, const RerootResult&) = default;
+};
+
+template <typename R, typename S, typename A>
+/// A rules engine that lists all actions of a state with their edges in one pass, e.g. to decode a state only once.
+/// REQUIREMENTS:
+/// - 'list_successors' lists the same actions as 'list_actions' (in the same order), each with its 'list_edges'.
+concept SuccessorListingRulesEngine = RulesEngine<R, S, A> && requires(R const const_rules_engine, S state) {
+	{ const_rules_engine.list_successors(state) } -> std::same_as<ActionSuccessors<S, A>>;
+};
+
+template <typename G, typename S, typename A>
+/// A graph container that expands all actions of a state at once (with a single lookup of the state).
+/// REQUIREMENTS:
+/// - 'expand_all_at' expands each listed action not expanded yet, as 'expand_at' would, and returns their count.
+concept BatchExpandingGraphContainer = GraphContainer<G, S, A> && requires(G graph,
+	S state,
+	ActionSuccessors<S, A> successors,
+	std::vector<std::pair<S, std::vector<A>>> next_states) {
+	{ graph.expand_all_at(state, successors, next_states) } -> std::same_as<size_t>;
+};
+
+template <typename R, typename S, typename A>
+/// A rules engine without chance: each state-action leads to exactly one successor state.
+/// REQUIREMENTS:
+/// - 'R::is_deterministic' is a constant expression evaluating to true.
+/// - 'list_edges' returns exactly one edge of weight 1 for each state-action.
+concept DeterministicRulesEngine = RulesEngine<R, S, A> && requires {
+	requires R::is_deterministic;
+};
+
+template <typename R, typename S, typename A>
+/// A rules engine that answers whether a state is terminal and how many actions it has without listing the actions,
+/// e.g. stopping at the first action found.
+/// REQUIREMENTS:
+/// - 'is_terminal' is true iff 'list_actions' returns empty, 'action_count' is the size of 'list_actions'.
+concept CountingRulesEngine = RulesEngine<R, S, A> && requires(R const const_rules_engine, S state) {
+	{ const_rules_engine.is_terminal(state) } -> std::same_as<bool>;
+	{ const_rules_engine.action_count(state) } -> std::same_as<size_t>;
+};
+
+template <typename R, typename S, typename A>
+/// A rules engine that writes the actions and edges of a state into buffers provided by the caller instead of returning
+/// new vectors, such that move generation does not allocate once the buffers are in place.
+/// REQUIREMENTS:
+/// - 'R::action_buffer' and 'R::edge_buffer' are default constructible and hold the most actions and edges of any
+/// state (e.g. fixed-capacity vectors sized at compile time).
+/// - 'list_actions_into' and 'list_edges_into' replace the buffer contents by what 'list_actions' and 'list_edges'
+/// return.
+concept BufferedRulesEngine = RulesEngine<R, S, A> && std::default_initializable<typename R::action_buffer> &&
+	std::default_initializable<typename R::edge_buffer> && requires(R const const_rules_engine,
+	S state,
+	A action,
+	typename R::action_buffer& actions,
+	typename R::edge_buffer& edges) {
+	{ const_rules_engine.list_actions_into(state, actions) } -> std::same_as<void>;
+	{ const_rules_engine.list_edges_into(state, action, edges) } -> std::same_as<void>;
+	{ std::as_const(actions) } -> ViewOf<A>;
+	{ std::as_const(edges) } -> ViewOf<ActionEdge<S>>;
+};
+
+template <typename R, typename S, typename A>
+/// A deterministic rules engine that applies an action to a state in place, e.g. for rollouts that play on the rules
+/// alone, without expanding a graph or allocating edges.
+/// REQUIREMENTS:
+/// - 'apply' replaces the state by the state of the only edge 'list_edges' returns for the state-action.
+concept InPlaceRulesEngine =
+	DeterministicRulesEngine<R, S, A> && requires(R const const_rules_engine, S& state_ref, A action) {
+	{ const_rules_engine.apply(state_ref, action) } -> std::same_as<void>;
+};
+
+template <typename G, typename S, typename A>
+/// A graph container storing the single successor of each expanded state-action of a deterministic graph.
+/// REQUIREMENTS:
+/// - 'child_at' returns the state of the only edge of an expanded state-action.
+concept SingleChildGraphContainer = GraphContainer<G, S, A> && requires(G const const_graph, S state, A action) {
+	{ const_graph.child_at(state, action) } -> std::same_as<S>;
+};
+
+template <typename G, typename S, typename A>
+/// A graph container that samples the successor of an expanded state-action itself, e.g. from a precomputed table.
+/// REQUIREMENTS:
+/// - for a uniformly distributed roll, 'sample_at' picks each edge with the probability of its weight.
+concept SamplingGraphContainer = GraphContainer<G, S, A> && requires(G const const_graph,
+	S state,
+	A action,
+	tools::UnitValue random_roll) {
+	{ const_graph.sample_at(state, action, random_roll) } -> std::same_as<S>;
+};
+
+template <typename G, typename S, typename A>
+/// A graph container that can reroot *without* dropping the expansions of the subgraph below the new roots.
+/// REQUIREMENTS:
+/// - 'retain_and_reroot' keeps all states (incl. their expansions) that are reachable from the new roots,
+/// frees all other states and reports the number of kept and freed states.
+concept RetainingGraphContainer = GraphContainer<G, S, A> && requires(G graph, std::vector<S> new_roots) {
+	{ graph.retain_and_reroot(new_roots) } -> std::same_as<RerootResult>;
+};
+
+template <typename G, typename S, typename A>
+/// A graph container that lists the actions of a state itself, on the first access to the state.
+/// REQUIREMENTS:
+/// - the 3-argument 'expand_at' registers the successor states without their actions, all (const) operations on such
+/// a state behave as if it had been added with the actions of the rules engine the container was constructed with.
+concept LazilyInitializingGraphContainer = GraphContainer<G, S, A> && requires(G graph,
+	S state,
+	A action,
+	std::vector<ActionEdge<S>> new_edges) {
+	{ graph.expand_at(state, action, new_edges) } -> std::same_as<bool>;
+};
+
+template <typename G, typename S, typename A>
+/// A graph container that interns its states into dense node ids, such that a search may run without hashing states.
+/// REQUIREMENTS:
+/// - node ids are 0, 1, ..., 'node_count' - 1 and stay valid until the graph is rerooted.
+/// - 'node_actions' lists the same actions as 'actions_at' (of the node's state), 'node_edges' the edges of the action
+/// at the given index in this list, referring to the successor states by node id.
+concept NodeIndexedGraphContainer = CountingGraphContainer<G, S, A> && requires(G const const_graph,
+	S state,
+	NodeId node,
+	size_t action_index) {
+	{ const_graph.node_of(state) } -> std::same_as<NodeId>;
+	{ const_graph.state_of(node) } -> std::same_as<S>;
+	{ const_graph.node_count() } -> std::same_as<size_t>;
+	{ const_graph.node_actions(node) } -> ViewOf<A>;
+	{ const_graph.node_edges(node, action_index) } -> ViewOf<ActionEdge<NodeId>>;
+};
+
+template <typename G, typename S, typename A>
+/// A graph container that reports the memory (in bytes) it *currently* holds and the peak over its lifetime,
+/// e.g. to size the number of parallel games.
+concept MemoryReportingGraphContainer = CountingGraphContainer<G, S, A> && requires(G const const_graph) {
+	{ const_graph.memory_usage() } -> std::same_as<size_t>;
+	{ const_graph.peak_memory_usage() } -> std::same_as<size_t>;
+};
+
 template <typename VP, typename S, typename A>
 concept VertexPrinter = Vertices<S, A>
 	&& std::is_default_constructible_v<VP>
@@ -147,4 +325,9 @@ concept Graph =
 	sag::GraphContainer<typename G::container, typename G::state, typename G::action> &&
 	sag::RulesEngine<typename G::rules, typename G::state, typename G::action> &&
 	sag::VertexPrinter<typename G::printer, typename G::state, typename G::action>;
+
+/// A graph of a deterministic rules engine, following an action needs no random roll
+template <typename G>
+concept DeterministicGraph =
+	Graph<G> && DeterministicRulesEngine<typename G::rules, typename G::state, typename G::action>;
 }  // namespace sag
@@ -1,12 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <iterator>
+#include <ranges>
+
 #include "GraphConcepts.h"
 #include "tools/BoundedValue.h"
 
 namespace sag {
 
-template <typename S>
-auto follow(std::vector<ActionEdge<S>> edges, tools::UnitValue random_roll) -> S {
+/// picks an edge by its weight, accepts the vector as well as the view accessors of a container (no copy)
+template <std::ranges::random_access_range E>
+auto follow(E const& edges, tools::UnitValue random_roll) {
 	float const threshold = random_roll.value();
 	float sum = 0.0F;
 	for (auto const& edge : edges) {
@@ -14,20 +20,160 @@ auto follow(std::vector<ActionEdge<S>> edges, tools::UnitValue random_roll) -> S
 		if (sum >= threshold)
 			return edge.state();
 	}
-	return edges.back().state();
+	return (*std::ranges::rbegin(edges)).state();
+}
+
+/// the only successor of an expanded state-action of a deterministic graph, no random roll needed
+template <typename S, typename A, GraphContainer<S, A> G>
+auto follow_single(G const& container, S state, A action) -> S {
+	if constexpr (SingleChildGraphContainer<G, S, A>) {
+		return container.child_at(state, action);
+	} else {
+		auto const edges = container.edges_view_at(state, action);
+		return (*std::ranges::begin(edges)).state();
+	}
+}
+
+/// the successor of an expanded state-action, rolls the random source only if the graph is not deterministic
+/// and samples in constant time if the container supports it
+template <Graph G, std::invocable RandomSource>
+auto follow(typename G::container const& container,
+	typename G::state state,
+	typename G::action action,
+	RandomSource&& random_source) -> typename G::state {
+	if constexpr (DeterministicGraph<G>) {
+		return follow_single(container, state, action);
+	} else if constexpr (SamplingGraphContainer<typename G::container, typename G::state, typename G::action>) {
+		return container.sample_at(state, action, std::forward<RandomSource>(random_source)());
+	} else {
+		return follow(container.edges_view_at(state, action), std::forward<RandomSource>(random_source)());
+	}
+}
+
+/// the actions of the state, generated into a buffer (and copied into a vector of the exact size) if the rules engine
+/// supports it, instead of growing the vector action by action
+template <typename S, typename A, RulesEngine<S, A> R>
+auto list_actions(R const& rules, S const& state) -> std::vector<A> {
+	if constexpr (BufferedRulesEngine<R, S, A>) {
+		typename R::action_buffer actions;
+		rules.list_actions_into(state, actions);
+		return {actions.begin(), actions.end()};
+	} else {
+		return rules.list_actions(state);
+	}
+}
+
+/// the edges of the state-action, generated into a buffer if the rules engine supports it (see 'list_actions')
+template <typename S, typename A, RulesEngine<S, A> R>
+auto list_edges(R const& rules, S const& state, A const& action) -> std::vector<ActionEdge<S>> {
+	if constexpr (BufferedRulesEngine<R, S, A>) {
+		typename R::edge_buffer edges;
+		rules.list_edges_into(state, action, edges);
+		return {edges.begin(), edges.end()};
+	} else {
+		return rules.list_edges(state, action);
+	}
+}
+
+/// whether the state has no actions, without listing them if the rules engine supports it
+template <typename S, typename A, RulesEngine<S, A> R>
+auto is_terminal(R const& rules, S const& state) -> bool {
+	if constexpr (CountingRulesEngine<R, S, A>) {
+		return rules.is_terminal(state);
+	} else if constexpr (BufferedRulesEngine<R, S, A>) {
+		typename R::action_buffer actions;
+		rules.list_actions_into(state, actions);
+		return actions.empty();
+	} else {
+		return rules.list_actions(state).empty();
+	}
+}
+
+/// the number of actions of the state, without listing them if the rules engine supports it
+template <typename S, typename A, RulesEngine<S, A> R>
+auto action_count(R const& rules, S const& state) -> size_t {
+	if constexpr (CountingRulesEngine<R, S, A>) {
+		return rules.action_count(state);
+	} else if constexpr (BufferedRulesEngine<R, S, A>) {
+		typename R::action_buffer actions;
+		rules.list_actions_into(state, actions);
+		return actions.size();
+	} else {
+		return rules.list_actions(state).size();
+	}
 }
 
 template <typename S, typename A, GraphContainer<S, A> G, RulesEngine<S, A> R>
 auto expand(G& container, R const& rules, S state, A action) -> bool {
 	if (container.is_expanded_at(state, action))
 		return false;
-	auto new_edges = rules.list_edges(state, action);
-	std::vector<std::pair<S, std::vector<A>>> next_states{};
-	for (auto const& edge : new_edges) {
-		auto actions = rules.list_actions(edge.state());
-		next_states.push_back({edge.state(), actions});
+	auto new_edges = list_edges<S, A>(rules, state, action);
+	if constexpr (LazilyInitializingGraphContainer<G, S, A>) {
+		// the container lists the actions of the successor states once they are accessed
+		return container.expand_at(state, action, std::move(new_edges));
+	} else {
+		std::vector<std::pair<S, std::vector<A>>> next_states{};
+		next_states.reserve(new_edges.size());
+		for (auto const& edge : new_edges) {
+			next_states.emplace_back(edge.state(), list_actions<S, A>(rules, edge.state()));
+		}
+		return container.expand_at(state, action, std::move(new_edges), std::move(next_states));
 	}
-	return container.expand_at(state, action, new_edges, next_states);
+}
+
+/// all actions of the state with their edges, in one pass if the rules engine supports it
+template <typename S, typename A, RulesEngine<S, A> R>
+auto list_successors(R const& rules, S state) -> ActionSuccessors<S, A> {
+	if constexpr (SuccessorListingRulesEngine<R, S, A>) {
+		return rules.list_successors(state);
+	} else {
+		ActionSuccessors<S, A> successors;
+		for (A const& action : list_actions<S, A>(rules, state))
+			successors.emplace_back(action, list_edges<S, A>(rules, state, action));
+		return successors;
+	}
+}
+
+/// expands all actions of the state not expanded yet, returns their count
+template <typename S, typename A, GraphContainer<S, A> G, RulesEngine<S, A> R>
+auto expand_all(G& container, R const& rules, S state) -> size_t {
+	if constexpr (BatchExpandingGraphContainer<G, S, A>) {
+		ActionSuccessors<S, A> successors;
+		{
+			auto const actions = container.actions_view_at(state);
+			std::vector<A> pending;
+			std::ranges::copy_if(actions, std::back_inserter(pending), [&](A const& action) {
+				return !container.is_expanded_at(state, action);
+			});
+			if (pending.empty())
+				return 0;
+			if (pending.size() == actions.size()) {
+				successors = list_successors<S, A>(rules, state);
+			} else {
+				for (A const& action : pending)
+					successors.emplace_back(action, list_edges<S, A>(rules, state, action));
+			}
+		}
+
+		std::vector<std::pair<S, std::vector<A>>> next_states{};
+		for (auto const& [action, edges] : successors) {
+			for (auto const& edge : edges)
+				next_states.emplace_back(edge.state(), list_actions<S, A>(rules, edge.state()));
+		}
+		return container.expand_all_at(state, std::move(successors), std::move(next_states));
+	} else {
+		size_t expanded = 0;
+		for (A const& action : container.actions_at(state)) {
+			if (expand(container, rules, state, action))
+				++expanded;
+		}
+		return expanded;
+	}
+}
+
+template <Graph G>
+auto expand_all(typename G::container& container, typename G::rules const& rules, typename G::state state) -> size_t {
+	return expand_all<typename G::state, typename G::action>(container, rules, state);
 }
 
 template <Graph G>
@@ -39,7 +185,7 @@ auto expand(
 
 template <Graph G>
 auto add_state(typename G::container& container, typename G::rules const& rules, typename G::state state) -> bool {
-	return container.add(state, rules.list_actions(state));
+	return container.add(state, list_actions<typename G::state, typename G::action>(rules, state));
 }
 
 }  // namespace sag
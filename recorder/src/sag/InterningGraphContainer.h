@@ -0,0 +1,215 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "GraphConcepts.h"
+
+namespace sag {
+
+/// State action graph container which interns each state once into a dense node id (in order of insertion).
+/// The edges refer to node ids (an 'ActionEdge<NodeId>' takes 8 bytes), hence a search may run on node ids only and
+/// keep its statistics in flat arrays (see 'NodeIndexedGraphContainer'). A state is hashed only to find its node.
+template <typename S, typename A>
+class InterningGraphContainer {
+ public:
+	template <RulesEngine<S, A> R>
+	explicit InterningGraphContainer(R const& rules_engine) {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		for (S const root : rules_engine.list_roots()) {
+			root_data.emplace_back(root, rules_engine.list_actions(root));
+		}
+		reset_roots_to(root_data);
+	}
+
+	friend auto operator==(const InterningGraphContainer& left, const InterningGraphContainer& right) -> bool {
+		if (left.roots_ != right.roots_ || left.states_.size() != right.states_.size() ||
+				left.edges_.size() != right.edges_.size())
+			return false;
+
+		// compare by content, the node ids depend on the order of insertion
+		for (NodeId left_node = 0; left_node < left.states_.size(); ++left_node) {
+			auto const found = right.ids_.find(left.states_[left_node]);
+			if (found == right.ids_.end() ||
+					!std::ranges::equal(left.node_actions(left_node), right.node_actions(found->second)))
+				return false;
+			for (size_t index = 0; index < left.node_actions(left_node).size(); ++index) {
+				if (!std::ranges::equal(left.edges_view_of(left_node, index), right.edges_view_of(found->second, index)))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] auto is_terminal_at(S state) const -> bool { return state_actions_[node_of(state)].count == 0; }
+	[[nodiscard]] auto is_expanded_at(S state, A action) const -> bool { return edge_count_at(state, action) > 0; }
+	[[nodiscard]] auto roots() const -> std::vector<S> { return roots_; }
+	[[nodiscard]] auto actions_at(S state) const -> std::vector<A> {
+		auto const view = actions_view_at(state);
+		return {view.begin(), view.end()};
+	}
+	[[nodiscard]] auto actions_view_at(S state) const -> std::span<A const> { return node_actions(node_of(state)); }
+
+	[[nodiscard]] auto edges_at(S state, A action) const -> std::vector<ActionEdge<S>> {
+		auto const view = edges_view_at(state, action);
+		return {view.begin(), view.end()};
+	}
+	[[nodiscard]] auto edges_view_at(S state, A action) const {
+		NodeId const node = node_of(state);
+		return edges_view_of(node, index_of(node, action));
+	}
+
+	[[nodiscard]] auto action_count_at(S state) const -> size_t { return state_actions_[node_of(state)].count; }
+
+	[[nodiscard]] auto edge_count_at(S state, A action) const -> size_t {
+		NodeId const node = node_of(state);
+		return node_edges(node, index_of(node, action)).size();
+	}
+
+	auto add(S state, std::vector<A> actions) -> bool;
+
+	auto clear_and_reroot(std::vector<S> new_roots) -> void {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		root_data.reserve(new_roots.size());
+		for (S root : new_roots) {
+			// unknown roots are (as in DefaultGraphContainer_v1) initialized without actions
+			root_data.emplace_back(root, ids_.contains(root) ? actions_at(root) : std::vector<A>{});
+		}
+
+		ids_.clear();
+		states_.clear();
+		state_actions_.clear();
+		actions_.clear();
+		action_edges_.clear();
+		edges_.clear();
+
+		reset_roots_to(root_data);
+	}
+
+	auto expand_at(
+		S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+		-> bool;
+
+	[[nodiscard]] auto action_count() const -> size_t { return actions_.size(); }
+	[[nodiscard]] auto state_count() const -> size_t { return states_.size(); }
+	[[nodiscard]] auto edge_count() const -> size_t { return edges_.size(); }
+
+	// node operations: node ids are stable until the next 'clear_and_reroot', the views until the next modification
+
+	[[nodiscard]] auto node_of(S const& state) const -> NodeId {
+		auto const found = ids_.find(state);
+		if (found == ids_.end())
+			throw std::out_of_range("state not found in graph container");
+		return found->second;
+	}
+	[[nodiscard]] auto state_of(NodeId node) const -> S { return states_[node]; }
+	[[nodiscard]] auto node_count() const -> size_t { return states_.size(); }
+
+	/// the (sorted) actions of the node
+	[[nodiscard]] auto node_actions(NodeId node) const -> std::span<A const> {
+		Range const range = state_actions_[node];
+		return std::span<A const>{actions_}.subspan(range.begin, range.count);
+	}
+
+	/// the edges of the node's action at the given index (in 'node_actions')
+	[[nodiscard]] auto node_edges(NodeId node, size_t action_index) const -> std::span<ActionEdge<NodeId> const> {
+		Range const range = action_edges_[state_actions_[node].begin + action_index];
+		return std::span<ActionEdge<NodeId> const>{edges_}.subspan(range.begin, range.count);
+	}
+
+ private:
+	static constexpr NodeId no_node = std::numeric_limits<NodeId>::max();
+
+	/// a contiguous range inside one of the pools
+	struct Range {
+		NodeId begin = 0;
+		NodeId count = 0;
+		friend auto operator<=>(const Range&, const Range&) = default;
+	};
+
+	std::vector<S> roots_;
+
+	// the interned states: node id by state, and state by node id
+	std::unordered_map<S, NodeId> ids_;
+	std::vector<S> states_;
+	std::vector<Range> state_actions_;
+
+	// action pool with a parallel edge range per action, and the edge pool
+	std::vector<A> actions_;
+	std::vector<Range> action_edges_;
+	std::vector<ActionEdge<NodeId>> edges_;
+
+	[[nodiscard]] auto index_of(NodeId node, A const& action) const -> size_t {
+		auto const actions = node_actions(node);
+		auto const found = std::ranges::lower_bound(actions, action);
+		if (found == actions.end() || *found != action)
+			throw std::out_of_range("action not found at state in graph container");
+		return static_cast<size_t>(found - actions.begin());
+	}
+
+	/// the edges of a node's action translated back to states
+	[[nodiscard]] auto edges_view_of(NodeId node, size_t action_index) const {
+		return node_edges(node, action_index) | std::views::transform([this](ActionEdge<NodeId> const& edge) {
+			return ActionEdge<S>{edge.weight().value(), states_[edge.state()]};
+		});
+	}
+
+	auto reset_roots_to(std::vector<std::pair<S, std::vector<A>>> const& root_data) -> void {
+		roots_.clear();
+		roots_.reserve(root_data.size());
+		for (auto const& [root, actions] : root_data) {
+			roots_.push_back(root);
+			add(root, actions);
+		}
+	}
+};
+
+template <typename S, typename A>
+auto InterningGraphContainer<S, A>::add(S state, std::vector<A> actions) -> bool {
+	assert(states_.size() < no_node && actions_.size() + actions.size() < no_node);
+	auto const [entry, inserted] = ids_.try_emplace(state, static_cast<NodeId>(states_.size()));
+	if (!inserted) {
+		// state already known/initialised (possibly visited via a different parent, etc.)
+		assert(state_actions_[entry->second].count == actions.size());
+		return false;
+	}
+
+	states_.push_back(state);
+	state_actions_.push_back({static_cast<NodeId>(actions_.size()), static_cast<NodeId>(actions.size())});
+
+	// initialize as unexpanded
+	std::ranges::sort(actions);
+	actions_.insert(actions_.end(), actions.begin(), actions.end());
+	action_edges_.resize(actions_.size());
+	return true;
+}
+
+template <typename S, typename A>
+auto InterningGraphContainer<S, A>::expand_at(
+	S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+	-> bool {
+	NodeId const node = node_of(state);
+	size_t const position = state_actions_[node].begin + index_of(node, action);
+	if (action_edges_[position].count > 0)
+		return false;
+
+	// intern the successors first, the edges refer to their node ids
+	for (auto& [child, actions] : next_states) {
+		add(child, std::move(actions));
+	}
+
+	assert(edges_.size() + new_edges.size() < no_node);
+	action_edges_[position] = {static_cast<NodeId>(edges_.size()), static_cast<NodeId>(new_edges.size())};
+	for (ActionEdge<S> const& edge : new_edges) {
+		edges_.emplace_back(edge.weight().value(), node_of(edge.state()));
+	}
+	return true;
+}
+
+}  // namespace sag
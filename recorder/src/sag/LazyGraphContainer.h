@@ -0,0 +1,167 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "GraphConcepts.h"
+#include "StateDetails.h"
+
+namespace sag {
+
+/// State action graph container which registers the successor states of an expansion without their actions.
+/// The actions of a state are listed (by the rules engine passed on construction) on the first access to the state,
+/// hence successor states never visited cost neither the listing nor the memory of their actions.
+/// Not thread-safe, not even for const operations.
+template <typename S, typename A>
+class LazyGraphContainer {
+ public:
+	template <RulesEngine<S, A> R>
+	explicit LazyGraphContainer(R const& rules_engine)
+			: list_actions_([rules_engine](S const& state) { return rules_engine.list_actions(state); }) {
+		for (S const root : rules_engine.list_roots()) {
+			roots_.push_back(root);
+			// initialize roots as unexpanded
+			data_.try_emplace(root);
+		}
+	}
+
+	/// compares the graphs as if all states were initialized
+	friend auto operator==(const LazyGraphContainer& left, const LazyGraphContainer& right) -> bool {
+		if (left.roots_ != right.roots_ || left.data_.size() != right.data_.size())
+			return false;
+		return std::ranges::all_of(left.data_, [&](auto const& entry) {
+			return right.data_.contains(entry.first) && left.details_of(entry.first) == right.details_of(entry.first);
+		});
+	}
+
+	[[nodiscard]] auto is_terminal_at(S state) const -> bool { return details_of(state).actions.empty(); }
+	[[nodiscard]] auto is_expanded_at(S state, A action) const -> bool { return edge_count_at(state, action) > 0; }
+	[[nodiscard]] auto roots() const -> std::vector<S> { return roots_; }
+	[[nodiscard]] auto actions_at(S state) const -> std::vector<A> { return details_of(state).actions; }
+	[[nodiscard]] auto actions_view_at(S state) const -> std::span<A const> { return details_of(state).actions; }
+
+	[[nodiscard]] auto edges_at(S state, A action) const -> std::vector<ActionEdge<S>> {
+		return details_of(state).edges_of(action);
+	}
+	[[nodiscard]] auto edges_view_at(S state, A action) const -> std::span<ActionEdge<S> const> {
+		return details_of(state).edges_of(action);
+	}
+
+	[[nodiscard]] auto action_count_at(S state) const -> size_t { return details_of(state).actions.size(); }
+
+	[[nodiscard]] auto edge_count_at(S state, A action) const -> size_t {
+		return details_of(state).edges_of(action).size();
+	}
+
+	auto add(S state, std::vector<A> actions) -> bool;
+
+	auto clear_and_reroot(std::vector<S> new_roots) -> void {
+		// keep the listed actions of known roots, unknown roots get their actions listed on first access
+		std::vector<std::pair<S, Node>> root_data;
+		for (S root : new_roots) {
+			auto const found = data_.find(root);
+			Node node;
+			if (found != data_.end() && found->second.initialized) {
+				node.details = StateDetails<S, A>(std::move(found->second.details.actions));
+				node.initialized = true;
+			}
+			root_data.emplace_back(root, std::move(node));
+		}
+
+		data_.clear();
+		actions_ = 0;
+		edges_ = 0;
+
+		roots_ = std::move(new_roots);
+		for (auto& [root, node] : root_data) {
+			if (data_.try_emplace(root, std::move(node)).second && data_.at(root).initialized)
+				actions_ += data_.at(root).details.actions.size();
+		}
+	}
+
+	/// expansion registering the successor states without actions (they are listed on first access)
+	auto expand_at(S state, A action, std::vector<ActionEdge<S>> new_edges) -> bool;
+
+	auto expand_at(
+		S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+		-> bool;
+
+	[[nodiscard]] auto action_count() const -> size_t { return actions_; }
+	[[nodiscard]] auto state_count() const -> size_t { return data_.size(); }
+	[[nodiscard]] auto edge_count() const -> size_t { return edges_; }
+
+	/// number of states whose actions are not listed yet
+	[[nodiscard]] auto uninitialized_state_count() const -> size_t {
+		return static_cast<size_t>(
+			std::ranges::count_if(data_, [](auto const& entry) { return !entry.second.initialized; }));
+	}
+
+ private:
+	struct Node {
+		mutable StateDetails<S, A> details;
+		mutable bool initialized = false;
+	};
+
+	std::function<std::vector<A>(S const&)> list_actions_;
+	std::vector<S> roots_;
+	std::unordered_map<S, Node> data_;
+
+	mutable size_t actions_{0};
+	size_t edges_{0};
+
+	[[nodiscard]] auto details_of(S const& state) const -> StateDetails<S, A>& {
+		Node const& node = data_.at(state);
+		if (!node.initialized) {
+			node.details = StateDetails<S, A>(list_actions_(state));
+			node.initialized = true;
+			actions_ += node.details.actions.size();
+		}
+		return node.details;
+	}
+};
+
+template <typename S, typename A>
+auto LazyGraphContainer<S, A>::add(S state, std::vector<A> actions) -> bool {
+	auto [entry, inserted] = data_.try_emplace(state);
+	Node& node = entry->second;
+	if (inserted || !node.initialized) {
+		actions_ += actions.size();
+		node.details = StateDetails<S, A>(std::move(actions));
+		node.initialized = true;
+		return inserted;
+	}
+	// else return false: state already known/initialised (possibly visited via a different parent, etc.)
+	assert(node.details.actions.size() == actions.size());
+	return false;
+}
+
+template <typename S, typename A>
+auto LazyGraphContainer<S, A>::expand_at(S state, A action, std::vector<ActionEdge<S>> new_edges) -> bool {
+	std::vector<ActionEdge<S>>& edges = details_of(state).edges_of(action);
+	if (!edges.empty())
+		return false;
+
+	for (ActionEdge<S> const& edge : new_edges) {
+		data_.try_emplace(edge.state());
+	}
+	edges_ += new_edges.size();
+	edges = std::move(new_edges);
+	return true;
+}
+
+template <typename S, typename A>
+auto LazyGraphContainer<S, A>::expand_at(
+	S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+	-> bool {
+	if (!expand_at(state, action, std::move(new_edges)))
+		return false;
+	for (auto& [child, actions] : next_states) {
+		add(child, std::move(actions));
+	}
+	return true;
+}
+
+}  // namespace sag
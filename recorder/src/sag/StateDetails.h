@@ -0,0 +1,38 @@
+#pragma once
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "GraphConcepts.h"
+
+namespace sag {
+
+/// Storage of a single state in node-based graph containers: the (sorted) actions of the state, each with its -
+/// possibly empty - edges at the same index.
+template <typename S, typename A>
+struct StateDetails {
+	std::vector<A> actions;
+	std::vector<std::vector<ActionEdge<S>>> edges;
+
+	StateDetails() = default;
+	explicit StateDetails(std::vector<A> unsorted_actions)
+			: actions(std::move(unsorted_actions)), edges(actions.size()) {
+		std::ranges::sort(actions);
+	}
+
+	friend auto operator==(const StateDetails&, const StateDetails&) -> bool = default;
+
+	[[nodiscard]] auto index_of(A const& action) const -> size_t {
+		auto const found = std::ranges::lower_bound(actions, action);
+		if (found == actions.end() || *found != action)
+			throw std::out_of_range("action not found at state in graph container");
+		return static_cast<size_t>(found - actions.begin());
+	}
+
+	[[nodiscard]] auto edges_of(A const& action) const -> std::vector<ActionEdge<S>> const& {
+		return edges[index_of(action)];
+	}
+	[[nodiscard]] auto edges_of(A const& action) -> std::vector<ActionEdge<S>>& { return edges[index_of(action)]; }
+};
+
+}  // namespace sag
@@ -0,0 +1,218 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+
+#include "GraphConcepts.h"
+#include "StateDetails.h"
+
+namespace sag {
+
+/// Thread-safe implementation of a state action graph container, based on lock striping: states are distributed
+/// (by hash) over a fixed number of stripes, each guarded by its own shared mutex. Any number of threads may read and
+/// expand concurrently, each state-action is expanded exactly once (the first expansion wins).
+template <typename S, typename A>
+class StripedGraphContainer {
+ public:
+	static constexpr bool is_concurrent = true;
+	static constexpr size_t stripe_count = 16;
+
+	template <RulesEngine<S, A> R>
+	explicit StripedGraphContainer(R const& rules_engine) {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		for (S const root : rules_engine.list_roots()) {
+			root_data.emplace_back(root, rules_engine.list_actions(root));
+		}
+		reset_roots_to(root_data);
+	}
+
+	friend auto operator==(const StripedGraphContainer&, const StripedGraphContainer&) -> bool = default;
+
+	[[nodiscard]] auto is_terminal_at(S state) const -> bool {
+		return read(state, [&state](StripeData const& data) { return data.states.at(state).actions.empty(); });
+	}
+	[[nodiscard]] auto is_expanded_at(S state, A action) const -> bool { return edge_count_at(state, action) > 0; }
+	[[nodiscard]] auto roots() const -> std::vector<S> {
+		std::shared_lock const lock{roots_.mutex};
+		return roots_.value;
+	}
+	[[nodiscard]] auto actions_at(S state) const -> std::vector<A> {
+		return read(state, [&state](StripeData const& data) { return data.states.at(state).actions; });
+	}
+
+	/// Stays valid until the next 'clear_and_reroot' (state storage is node-based, the actions are never modified)
+	[[nodiscard]] auto actions_view_at(S state) const -> std::span<A const> {
+		return read(state, [&state](StripeData const& data) { return std::span<A const>{data.states.at(state).actions}; });
+	}
+
+	[[nodiscard]] auto edges_at(S state, A action) const -> std::vector<ActionEdge<S>> {
+		return read(state, [&state, &action](StripeData const& data) { return data.states.at(state).edges_of(action); });
+	}
+
+	/// Stays valid until the next 'clear_and_reroot' (the edges are set at most once)
+	[[nodiscard]] auto edges_view_at(S state, A action) const -> std::span<ActionEdge<S> const> {
+		return read(state, [&state, &action](StripeData const& data) {
+			return std::span<ActionEdge<S> const>{data.states.at(state).edges_of(action)};
+		});
+	}
+
+	[[nodiscard]] auto action_count_at(S state) const -> size_t {
+		return read(state, [&state](StripeData const& data) { return data.states.at(state).actions.size(); });
+	}
+
+	[[nodiscard]] auto edge_count_at(S state, A action) const -> size_t {
+		return read(
+			state, [&state, &action](StripeData const& data) { return data.states.at(state).edges_of(action).size(); });
+	}
+
+	auto add(S state, std::vector<A> actions) -> bool {
+		size_t const action_count = actions.size();
+		StateDetails<S, A> state_details{std::move(actions)};  // prepare outside of the lock
+
+		Stripe& stripe = stripe_of(state);
+		std::unique_lock const lock{stripe.mutex};
+		if (stripe.value.states.try_emplace(state, std::move(state_details)).second) {
+			stripe.value.actions += action_count;
+			return true;
+		}
+		// else return false: state already known/initialised (possibly visited via a different parent, etc.)
+		assert(stripe.value.states.at(state).actions.size() == action_count);
+		return false;
+	}
+
+	/// Not atomic: concurrent operations may observe the graph partially cleared, but never in an invalid state.
+	auto clear_and_reroot(std::vector<S> new_roots) -> void {
+		std::vector<std::pair<S, std::vector<A>>> root_data;
+		for (S root : new_roots) {
+			Stripe const& stripe = stripe_of(root);
+			std::shared_lock const lock{stripe.mutex};
+			auto const found = stripe.value.states.find(root);
+			root_data.emplace_back(root, found != stripe.value.states.end() ? found->second.actions : std::vector<A>{});
+		}
+
+		for (Stripe& stripe : stripes_) {
+			std::unique_lock const lock{stripe.mutex};
+			stripe.value = {};
+		}
+
+		reset_roots_to(root_data);
+	}
+
+	/// The successor states are added *before* the edges get published, hence any thread that sees the edges also
+	/// finds their states.
+	auto expand_at(
+		S state, A action, std::vector<ActionEdge<S>> new_edges, std::vector<std::pair<S, std::vector<A>>> next_states)
+		-> bool {
+		if (is_expanded_at(state, action))
+			return false;
+
+		for (auto& [child, actions] : next_states) {
+			add(child, std::move(actions));
+		}
+
+		Stripe& stripe = stripe_of(state);
+		std::unique_lock const lock{stripe.mutex};
+		std::vector<ActionEdge<S>>& edges = stripe.value.states.at(state).edges_of(action);
+		if (!edges.empty())
+			return false;  // another thread expanded in the meantime
+		stripe.value.edges += new_edges.size();
+		edges = std::move(new_edges);
+		return true;
+	}
+
+	[[nodiscard]] auto action_count() const -> size_t { return sum_over_stripes(&StripeData::actions); }
+	[[nodiscard]] auto state_count() const -> size_t {
+		size_t result = 0;
+		for (Stripe const& stripe : stripes_) {
+			std::shared_lock const lock{stripe.mutex};
+			result += stripe.value.states.size();
+		}
+		return result;
+	}
+	[[nodiscard]] auto edge_count() const -> size_t { return sum_over_stripes(&StripeData::edges); }
+
+ private:
+	/// Value guarded by a shared mutex, copying and comparing acquire the locks
+	template <typename T>
+	struct Guarded {
+		mutable std::shared_mutex mutex;
+		T value;
+
+		Guarded() = default;
+		~Guarded() = default;
+		Guarded(Guarded const& other) : value(other.read_copy()) {}
+		Guarded(Guarded&& other) noexcept : value(std::move(other.value)) {}
+		auto operator=(Guarded const& other) -> Guarded& {
+			if (this != &other) {
+				T copy = other.read_copy();
+				std::unique_lock const lock{mutex};
+				value = std::move(copy);
+			}
+			return *this;
+		}
+		auto operator=(Guarded&& other) noexcept -> Guarded& {
+			std::unique_lock const lock{mutex};
+			value = std::move(other.value);
+			return *this;
+		}
+		friend auto operator==(Guarded const& left, Guarded const& right) -> bool {
+			if (&left == &right)
+				return true;
+			return left.read_copy() == right.read_copy();
+		}
+
+		[[nodiscard]] auto read_copy() const -> T {
+			std::shared_lock const lock{mutex};
+			return value;
+		}
+	};
+
+	struct StripeData {
+		std::unordered_map<S, StateDetails<S, A>> states;
+		size_t actions{0};
+		size_t edges{0};
+		friend auto operator==(const StripeData&, const StripeData&) -> bool = default;
+	};
+	using Stripe = Guarded<StripeData>;
+
+	Guarded<std::vector<S>> roots_;
+	std::array<Stripe, stripe_count> stripes_;
+
+	[[nodiscard]] auto stripe_of(S const& state) -> Stripe& { return stripes_[std::hash<S>{}(state) % stripe_count]; }
+	[[nodiscard]] auto stripe_of(S const& state) const -> Stripe const& {
+		return stripes_[std::hash<S>{}(state) % stripe_count];
+	}
+
+	template <typename Reader>
+	[[nodiscard]] auto read(S const& state, Reader reader) const {
+		Stripe const& stripe = stripe_of(state);
+		std::shared_lock const lock{stripe.mutex};
+		return reader(stripe.value);
+	}
+
+	[[nodiscard]] auto sum_over_stripes(size_t StripeData::*counter) const -> size_t {
+		size_t result = 0;
+		for (Stripe const& stripe : stripes_) {
+			std::shared_lock const lock{stripe.mutex};
+			result += stripe.value.*counter;
+		}
+		return result;
+	}
+
+	auto reset_roots_to(std::vector<std::pair<S, std::vector<A>>> const& root_data) -> void {
+		std::vector<S> roots;
+		roots.reserve(root_data.size());
+		for (auto [root, actions] : root_data) {
+			roots.push_back(root);
+			// initialize roots as unexpanded
+			add(root, actions);
+		}
+		std::unique_lock const lock{roots_.mutex};
+		roots_.value = std::move(roots);
+	}
+};
+
+}  // namespace sag
@@ -2,63 +2,40 @@
 
 #include <fmt/format.h>
 
+#include <bit>
+#include <cassert>
 #include <vector>
 
 namespace sag::tic_tac_toe {
-auto Rules::list_actions(Graph::state state) -> std::vector<Graph::action> {
-	Board const board = decode(state);
-
-	// skip if opponent has won
-	if (opponent_has_won(board))
-		return {};
 
-	std::vector<Graph::action> actions;
+namespace {
 
-	for (size_t i = 0; i < BoardSize; i++) {
-		if (board[i] == 0)
-			actions.emplace_back(static_cast<Graph::action>(i));
+constexpr auto decode_board(Graph::state state_id) -> Board {
+	Board board{};
+	for (Graph::state& entry : board) {
+		entry = static_cast<Graph::state>(state_id % 3);
+		state_id /= 3;
 	}
-	return actions;
-}
-
-auto Rules::list_edges(Graph::state state, Graph::action action) -> std::vector<ActionEdge<Graph::state>> {
-	Board board = decode(state);
-	++board[static_cast<size_t>(action)];
-	return {ActionEdge<Graph::state>(1.0, encode(invert(board)))};
-}
-
-auto Rules::score(Graph::state state) -> tools::Score {
-	return tools::Score(list_actions(state).empty() ? -1.0F : 0.0F);
+	return board;
 }
 
-auto Rules::encode(const Board& board) -> Graph::state {
+constexpr auto encode_board(const Board& board) -> Graph::state {
 	Graph::state value = 0;
-
-	for (size_t i = 0; i < BoardSize; i++) {
-		value += static_cast<Graph::state>(board[i] * static_cast<Graph::state>(std::pow(3, i)));
-	}
+	for (size_t i = BoardSize; i > 0; i--)
+		value = static_cast<Graph::state>(value * 3 + board[i - 1]);
 	return value;
 }
 
-auto Rules::decode(Graph::state state_id) -> Board {
-	Board board{};
-	for (size_t i = BoardSize; i > 0; i--) {
-		board[i - 1] = static_cast<unsigned char>(state_id / std::pow(3, i - 1));
-		state_id -= static_cast<Graph::state>(board[i - 1] * std::pow(3, i - 1));
-	}
-	return board;
-}
-
-auto Rules::invert(Board board) -> Board {
-	for (size_t i = 0; i < BoardSize; i++) {
-		if (board[i] > 0)
-			board[i] = 1 + (board[i] % 2);
+constexpr auto invert(Board board) -> Board {
+	for (Graph::state& entry : board) {
+		if (entry > 0)
+			entry = static_cast<Graph::state>(1 + (entry % 2));
 	}
 	return board;
 }
 
 // NOLINTBEGIN(*-magic-numbers)
-auto Rules::opponent_has_won(const Board& board) -> bool {
+constexpr auto opponent_has_won(const Board& board) -> bool {
 	if (board[0] == 2) {
 		if (2 == board[1] && 2 == board[2])
 			return true;
@@ -83,6 +60,121 @@ auto Rules::opponent_has_won(const Board& board) -> bool {
 }
 // NOLINTEND(*-magic-numbers)
 
+/// everything the rules need to know about an encoding
+struct TableEntry {
+	unsigned short action_mask = 0;                    // bit i is set iff action i is legal
+	std::array<Graph::state, BoardSize> successors{};  // the state after action i (on an empty position)
+	bool is_terminal = false;                          // no legal actions, either the opponent has won or a draw
+};
+
+/// too many operations for the limits of compile time evaluation, hence computed at runtime (see 'entry_of')
+auto build_table() -> std::array<TableEntry, StateCount> {
+	std::array<Graph::state, BoardSize> powers_of_3{};
+	for (Graph::state power = 1; Graph::state& entry : powers_of_3) {
+		entry = power;
+		power = static_cast<Graph::state>(power * 3);
+	}
+
+	std::array<TableEntry, StateCount> result{};
+	for (size_t state_id = 0; state_id < StateCount; ++state_id) {
+		Board const board = decode_board(static_cast<Graph::state>(state_id));
+		bool const has_ended = opponent_has_won(board);
+		// a new unit of the active player (1) is an opponent unit (2) after inverting for the next turn
+		Graph::state const inverted = encode_board(invert(board));
+		TableEntry& entry = result[state_id];
+		for (size_t i = 0; i < BoardSize; i++) {
+			if (board[i] != 0)
+				continue;
+			entry.successors[i] = static_cast<Graph::state>(inverted + 2 * powers_of_3[i]);
+			if (!has_ended)
+				entry.action_mask = static_cast<unsigned short>(entry.action_mask | (1U << i));
+		}
+		entry.is_terminal = entry.action_mask == 0;
+	}
+	return result;
+}
+
+auto entry_of(Graph::state state) -> TableEntry const& {
+	// built on first use, such that rules used during the static initialization of other objects see a complete table
+	static std::array<TableEntry, StateCount> const table = build_table();
+	assert(state < StateCount);  // sanity check, larger values do not encode a board
+	return table[state];
+}
+
+}  // namespace
+
+auto Rules::list_actions(Graph::state state) -> std::vector<Graph::action> {
+	std::vector<Graph::action> actions;
+	for (unsigned mask = entry_of(state).action_mask; mask != 0; mask &= mask - 1)
+		actions.emplace_back(static_cast<Graph::action>(std::countr_zero(mask)));
+	return actions;
+}
+
+auto Rules::list_edges(Graph::state state, Graph::action action) -> std::vector<ActionEdge<Graph::state>> {
+	assert(decode(state)[static_cast<size_t>(action)] == 0);  // only empty positions have a successor
+	return {ActionEdge<Graph::state>(1.0, entry_of(state).successors[static_cast<size_t>(action)])};
+}
+
+auto Rules::list_actions_into(Graph::state state, action_buffer& actions) -> void {
+	actions.clear();
+	for (unsigned mask = entry_of(state).action_mask; mask != 0; mask &= mask - 1)
+		actions.push_back(static_cast<Graph::action>(std::countr_zero(mask)));
+}
+
+auto Rules::list_edges_into(Graph::state state, Graph::action action, edge_buffer& edges) -> void {
+	assert(decode(state)[static_cast<size_t>(action)] == 0);  // only empty positions have a successor
+	edges.clear();
+	edges.emplace_back(1.0F, entry_of(state).successors[static_cast<size_t>(action)]);
+}
+
+auto Rules::apply(Graph::state& state, Graph::action action) -> void {
+	assert(decode(state)[static_cast<size_t>(action)] == 0);  // only empty positions have a successor
+	state = entry_of(state).successors[static_cast<size_t>(action)];
+}
+
+auto Rules::list_successors(Graph::state state) -> ActionSuccessors<Graph::state, Graph::action> {
+	TableEntry const& entry = entry_of(state);
+	ActionSuccessors<Graph::state, Graph::action> successors;
+	for (unsigned mask = entry.action_mask; mask != 0; mask &= mask - 1) {
+		auto const i = static_cast<size_t>(std::countr_zero(mask));
+		successors.emplace_back(static_cast<Graph::action>(i),
+			std::vector<ActionEdge<Graph::state>>{ActionEdge<Graph::state>(1.0, entry.successors[i])});
+	}
+	return successors;
+}
+
+auto Rules::score(Graph::state state) -> tools::Score {
+	return tools::Score(entry_of(state).is_terminal ? -1.0F : 0.0F);
+}
+
+auto Rules::is_terminal(Graph::state state) -> bool {
+	return entry_of(state).is_terminal;
+}
+
+auto Rules::action_count(Graph::state state) -> size_t {
+	return static_cast<size_t>(std::popcount(entry_of(state).action_mask));
+}
+
+auto Rules::encode(const Board& board) -> Graph::state {
+	return encode_board(board);
+}
+
+auto Rules::decode(Graph::state state_id) -> Board {
+	return decode_board(state_id);
+}
+
+auto Symmetry::transform_state(Graph::state state, size_t transform) -> Graph::state {
+	Board const board = decode_board(state);
+	Board transformed{};
+	for (size_t i = 0; i < BoardSize; i++)
+		transformed[Grid::permutations[transform][i]] = board[i];
+	return encode_board(transformed);
+}
+
+auto Symmetry::transform_action(Graph::action action, size_t transform) -> Graph::action {
+	return static_cast<Graph::action>(Grid::permutations[transform][static_cast<size_t>(action)]);
+}
+
 auto Rules::to_string(const Board& board, bool line_break) -> std::string {
 	int empty_spaces = 0;
 	for (auto const& entry : board) {
@@ -1,9 +1,11 @@
 #pragma once
 #include <array>
 
+#include "CanonicalRules.h"
 #include "DefaultGraphContainer_v1.h"
 #include "GraphConcepts.h"
 #include "sag/GraphConcepts.h"
+#include "tools/StaticVector.h"
 
 namespace sag::tic_tac_toe {
 
@@ -19,26 +21,58 @@ struct Graph {
 };
 
 const size_t BoardSize = 9;
+const size_t StateCount = 19683;  // 3^BoardSize encodings, reachable or not
 using Board = std::array<Graph::state, BoardSize>;  // board is of size 3x3 with entries 0=empty, 1=player, 2=opponent
 
 class Rules {
  public:
+	static constexpr bool is_deterministic = true;
+
 	static auto list_roots() -> std::vector<Graph::state> { return {0}; }
 	static auto list_actions(Graph::state state) -> std::vector<Graph::action>;
 	static auto list_edges(Graph::state state, Graph::action action) -> std::vector<ActionEdge<Graph::state>>;
+	static auto list_successors(Graph::state state) -> ActionSuccessors<Graph::state, Graph::action>;
 	static auto score(Graph::state state) -> tools::Score;
 
+	/// concept CountingRulesEngine:
+	static auto is_terminal(Graph::state state) -> bool;
+	static auto action_count(Graph::state state) -> size_t;
+
+	/// concept BufferedRulesEngine:
+	using action_buffer = tools::StaticVector<Graph::action, BoardSize>;
+	using edge_buffer = tools::StaticVector<ActionEdge<Graph::state>, 1>;
+	static auto list_actions_into(Graph::state state, action_buffer& actions) -> void;
+	static auto list_edges_into(Graph::state state, Graph::action action, edge_buffer& edges) -> void;
+
+	/// concept InPlaceRulesEngine:
+	static auto apply(Graph::state& state, Graph::action action) -> void;
+
 	static auto decode(Graph::state state_id) -> Board;
 	static auto encode(const Board& board) -> Graph::state;
 	static auto to_string(const Board& board, bool line_break) -> std::string;
 
- private:
-	// tic tac toe is a very simple game - no member fields, no caches, all methods are static
-	static auto invert(Board board) -> Board;
-	static auto opponent_has_won(const Board& board) -> bool;
+	// tic tac toe is a very simple game - no member fields, all methods are static and look up a table of all
+	// encodings, computed once on first use (see TicTacToe.cpp)
+};
+
+static_assert(DeterministicRulesEngine<Rules, Graph::state, Graph::action>);
+static_assert(SuccessorListingRulesEngine<Rules, Graph::state, Graph::action>);
+static_assert(BufferedRulesEngine<Rules, Graph::state, Graph::action>);
+static_assert(CountingRulesEngine<Rules, Graph::state, Graph::action>);
+static_assert(InPlaceRulesEngine<Rules, Graph::state, Graph::action>);
+
+/// the rotations and reflections of the board, e.g. for 'CanonicalRules<Rules, Symmetry>'
+struct Symmetry {
+	using Grid = GridSymmetries<3, 3>;
+	static constexpr size_t transform_count = Grid::transform_count;
+
+	static auto transform_state(Graph::state state, size_t transform) -> Graph::state;
+	static auto transform_action(Graph::action action, size_t transform) -> Graph::action;
+	static auto inverse(size_t transform) -> size_t { return Grid::inverses[transform]; }
+	static auto precedes(Graph::state lhs, Graph::state rhs) -> bool { return lhs < rhs; }
 };
 
-static_assert(RulesEngine<Rules, Graph::state, Graph::action>);
+static_assert(sag::Symmetry<Symmetry, Graph::state, Graph::action>);
 
 class Container : public DefaultGraphContainer_v1<Graph::state, Graph::action> {
  public:
@@ -82,6 +82,21 @@ class MatchRecorder {
 		logger_->info("match recorder status: {} players ({}), running={}", players_.size(), player_names, is_running_);
 	}
 
+	/// reroots the graph at the given state, retaining the subgraph below it if the container supports it
+	auto reroot(typename G::state state) -> void {
+		if constexpr (sag::MemoryReportingGraphContainer<typename G::container, typename G::state, typename G::action>) {
+			logger_->debug(
+				"graph memory usage {:L} bytes (peak {:L} bytes)", graph_.memory_usage(), graph_.peak_memory_usage());
+		}
+		if constexpr (sag::RetainingGraphContainer<typename G::container, typename G::state, typename G::action>) {
+			RerootResult const result = graph_.retain_and_reroot({state});
+			logger_->debug("graph rerooted, kept {:L} states and freed {:L} states", result.kept_states, result.freed_states);
+		} else {
+			graph_.clear_and_reroot({state});
+			logger_->debug("graph cleared");
+		}
+	}
+
 	auto record_once() -> void {
 		using State = typename G::state;
 		using Action = typename G::action;
@@ -110,18 +125,17 @@ class MatchRecorder {
 			if (!graph_.is_expanded_at(state, action))
 				sag::expand(graph_, rules_, state, action);
 
-			state = sag::follow(graph_.edges_at(state, action), tools::UnitValue{unit_distribution_(rng_)});
+			state = sag::follow<G>(graph_, state, action, [this] { return tools::UnitValue{unit_distribution_(rng_)}; });
 
 			if constexpr (sag::CountingGraphContainer<typename G::container, typename G::state, typename G::action>) {
-				logger_->debug("clearing and rerooting graph with {:L} states, {:L} actions and {:L} edges ...",
+				logger_->debug("rerooting graph with {:L} states, {:L} actions and {:L} edges ...",
 					graph_.state_count(),
 					graph_.action_count(),
 					graph_.edge_count());
 			} else {
-				logger_->debug("clearing and rerooting graph ...");
+				logger_->debug("rerooting graph ...");
 			}
-			graph_.clear_and_reroot({state});
-			logger_->debug("graph cleared");
+			reroot(state);
 		}
 		match.end = std::chrono::steady_clock::now();
 		match.end_state = state;
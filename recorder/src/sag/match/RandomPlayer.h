@@ -19,9 +19,20 @@ class RandomPlayer : public ProbabilisticPlayer<G> {
 	auto operator==(const RandomPlayer& other) const -> bool = default;
 
 	[[nodiscard]] auto choose_play(
-		typename G::state state, typename G::container& graph, typename G::rules const& /*unused*/) ->
+		typename G::state state, typename G::container& graph, typename G::rules const& rules) ->
 		typename G::action override {
-		std::vector<typename G::action> const actions = graph.actions_at(state);
+		if constexpr (BufferedRulesEngine<typename G::rules, typename G::state, typename G::action>) {
+			// generated into a buffer on the stack, no allocation
+			typename G::rules::action_buffer actions;
+			rules.list_actions_into(state, actions);
+			return pick(actions);
+		} else {
+			return pick(graph.actions_view_at(state));
+		}
+	}
+
+ private:
+	[[nodiscard]] auto pick(auto const& actions) -> typename G::action {
 		size_t random_index = std::min(actions.size() - 1,
 			static_cast<size_t>(std::floor(ProbabilisticPlayer<G>::roll().value() * static_cast<float>(actions.size()))));
 		return actions[random_index];
@@ -4,6 +4,7 @@
 #include <functional>
 #include <iterator>
 #include <random>
+#include <type_traits>
 
 #include "StatsContainer.h"
 #include "sag/ExampleGraph.h"
@@ -18,24 +19,142 @@ struct Path {
 };
 
 // --------------------------------------------------------------------------------------------------------------------
-//			toolset: action estimate
+//			node indexed graphs: the same routine on dense node ids, without hashing states
 // --------------------------------------------------------------------------------------------------------------------
 
-/// compute stats for each action: average over its resulting state values
+template <typename G>
+concept NodeIndexedGraph =
+	Graph<G> && NodeIndexedGraphContainer<typename G::container, typename G::state, typename G::action>;
+
+/// the statistics used by default for a graph: flat by node id if possible, else by state
 template <Graph G>
-auto action_estimates_at(
-	typename G::state state, typename G::container const& graph, StatsContainer<typename G::state> auto const& stats)
+using StatisticsFor = std::conditional_t<NodeIndexedGraph<G>, NodeStatistics, Statistics<typename G::state>>;
+
+/// as 'action_estimates_at', on node ids
+template <NodeIndexedGraph G>
+auto action_estimates_by_node(typename G::state state, typename G::container const& graph, NodeStatistics const& stats)
 	-> std::vector<float> {
+	NodeId const node = graph.node_of(state);
 	std::vector<float> action_estimates;
-	for (typename G::action action : graph.actions_at(state)) {
+	for (size_t index = 0; index < graph.node_actions(node).size(); ++index) {
 		float action_value = 0.0;
-		for (auto edge : graph.edges_at(state, action))
+		for (auto const& edge : graph.node_edges(node, index))
 			action_value += edge.weight().value() * stats.at(edge.state()).Q;
 		action_estimates.push_back(action_value);
 	}
 	return action_estimates;
 }
 
+template <NodeIndexedGraph G>
+[[nodiscard]] auto upper_confidence_bound_by_node(NodeId node,
+	size_t action_index,
+	typename G::container const& graph,
+	NodeStatistics const& stats,
+	tools::NonNegative explore_constant) -> float {
+	float value_estimate = 0.0;
+	int action_visits = 0;
+	for (auto const& edge : graph.node_edges(node, action_index)) {
+		StatsEntry const entry = stats.at(edge.state());
+		value_estimate += edge.weight().value() * entry.Q;
+		action_visits += entry.N;
+	}
+
+	return value_estimate -
+				 explore_constant.value() * static_cast<float>(std::sqrt(stats.at(node).N / (1 + action_visits)));
+}
+
+template <NodeIndexedGraph G>
+auto select_by_node(NodeId node,
+	NodeStatistics const& stats,
+	typename G::container const& graph,
+	bool sample_actions_uniformly,
+	std::function<float(NodeId, size_t)> const& upper_confidence_bound,
+	std::function<tools::UnitValue(void)>& random_source) -> Path<NodeId> {
+	Path<NodeId> path{false, {node}};
+	for (size_t action_count = graph.node_actions(node).size(); action_count > 0;
+			 action_count = graph.node_actions(node).size()) {
+		// check upper_confidence_bound requirement
+		for (size_t index = 0; index < action_count; ++index) {
+			auto const edges = graph.node_edges(node, index);
+			if (edges.empty() || std::ranges::any_of(edges, [&](auto const& edge) { return !stats.has(edge.state()); }))
+				return path;
+		}
+
+		size_t min_index = 0;
+		float min_value = upper_confidence_bound(node, 0);
+		for (size_t index = 1; index < action_count; ++index) {
+			float const value = upper_confidence_bound(node, index);
+			if (value < min_value) {
+				min_value = value;
+				min_index = index;
+			}
+		}
+
+		auto const edges = graph.node_edges(node, min_index);
+		if constexpr (DeterministicGraph<G>) {
+			node = edges.front().state();
+		} else if (sample_actions_uniformly) {
+			node = std::ranges::min_element(edges, {}, [&](auto const& edge) { return stats.at(edge.state()).N; })->state();
+		} else {
+			node = sag::follow(edges, random_source());
+		}
+		path.values.push_back(node);
+	}
+
+	path.terminal = true;
+	return path;
+}
+
+template <NodeIndexedGraph G>
+void expand_by_node(Path<NodeId> const& path,
+	NodeStatistics& stats,
+	typename G::container& graph,
+	typename G::rules const& rules,
+	std::function<tools::Score(NodeId)> const& initial_value_estimate) {
+	NodeId const end_node = path.values.back();
+	typename G::state const end_state = graph.state_of(end_node);
+
+	if (path.terminal) {
+		if (!stats.has(end_node))
+			stats.initialize(end_node, rules.score(end_state));
+		return;
+	}
+
+	// if path is not terminal, then the U-bound requirement failed
+	sag::expand_all<G>(graph, rules, end_state);
+	for (size_t index = 0; index < graph.node_actions(end_node).size(); ++index) {
+		// index based: the initial value estimate may modify the graph and thereby invalidate its views
+		for (size_t edge = 0; edge < graph.node_edges(end_node, index).size(); ++edge) {
+			NodeId const child = graph.node_edges(end_node, index)[edge].state();
+			if (!stats.has(child))
+				stats.initialize(child, initial_value_estimate(child));
+		}
+	}
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+//			toolset: action estimate
+// --------------------------------------------------------------------------------------------------------------------
+
+/// compute stats for each action: average over its resulting state values (of any states, if on node ids)
+template <Graph G, typename Stats>
+	requires StatsContainer<Stats, typename G::state> || (NodeIndexedGraph<G> && std::same_as<Stats, NodeStatistics>)
+auto action_estimates_at(typename G::state state, typename G::container const& graph, Stats const& stats)
+	-> std::vector<float> {
+	if constexpr (NodeIndexedGraph<G> && std::same_as<Stats, NodeStatistics>) {
+		return action_estimates_by_node<G>(state, graph, stats);
+	} else {
+		std::vector<float> action_estimates;
+		for (typename G::action action : graph.actions_view_at(state)) {
+			float action_value = 0.0;
+			for (auto const& edge : graph.edges_view_at(state, action))
+				action_value += edge.weight().value() * stats.at(edge.state()).Q;
+			action_estimates.push_back(action_value);
+		}
+		return action_estimates;
+	}
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 //			the core MCTS routine: selection - expansion - update
 // --------------------------------------------------------------------------------------------------------------------
@@ -68,33 +187,43 @@ auto select(typename G::state state,
 	std::function<tools::UnitValue(void)>& random_source) -> Path<typename G::state> {
 	Path<typename G::state> path{false, {state}};
 	while (!graph.is_terminal_at(state)) {
-		auto const actions = graph.actions_at(state);
+		// the graph is not modified during selection, hence the views stay valid
+		auto const actions = graph.actions_view_at(state);
 
 		// check upper_confidence_bound requirement
 		auto requirement_failed = [&](typename G::action action) {
 			if (!graph.is_expanded_at(state, action))
 				return true;
-			return std::ranges::any_of(
-				graph.edges_at(state, action), [&](ActionEdge<typename G::state> edge) { return !stats.has(edge.state()); });
+			return std::ranges::any_of(graph.edges_view_at(state, action),
+				[&](ActionEdge<typename G::state> const& edge) { return !stats.has(edge.state()); });
 		};
 		if (std::ranges::any_of(actions, requirement_failed))
 			return path;
 
-		// cache upper_confidence_bound values to avoid concurrencey issues
-		// (another thread might update stats while this one executes std::min_element)
-		std::vector<double> ucb_values;
-		std::ranges::transform(
-			actions, std::back_inserter(ucb_values), [&](auto action) { return upper_confidence_bound(state, action); });
-		auto min_index = static_cast<size_t>(std::distance(ucb_values.begin(), std::ranges::min_element(ucb_values)));
-
-		if (sample_actions_uniformly) {
-			auto edges = graph.edges_at(state, actions[min_index]);
-			state = std::ranges::min_element(
-				edges, [&](const ActionEdge<typename G::state>& left, const ActionEdge<typename G::state>& right) {
-					return stats.at(left.state()).N < stats.at(right.state()).N;
-				})->state();
+		// evaluate each upper_confidence_bound exactly once to avoid concurrencey issues
+		// (another thread might update stats while this one searches the minimum)
+		size_t min_index = 0;
+		double min_value = upper_confidence_bound(state, actions[0]);
+		for (size_t index = 1; index < actions.size(); ++index) {
+			double const value = upper_confidence_bound(state, actions[index]);
+			if (value < min_value) {
+				min_value = value;
+				min_index = index;
+			}
+		}
+
+		if constexpr (DeterministicGraph<G>) {
+			// a single successor: no roll, no comparison of visits
+			state = sag::follow_single(graph, state, actions[min_index]);
+		} else if (sample_actions_uniformly) {
+			auto const edges = graph.edges_view_at(state, actions[min_index]);
+			state = (*std::ranges::min_element(edges,
+								 [&](const ActionEdge<typename G::state>& left, const ActionEdge<typename G::state>& right) {
+									 return stats.at(left.state()).N < stats.at(right.state()).N;
+								 }))
+								.state();
 		} else {
-			state = sag::follow<typename G::state>(graph.edges_at(state, actions[min_index]), random_source());
+			state = sag::follow<G>(graph, state, actions[min_index], random_source);
 		}
 		path.values.push_back(state);
 	}
@@ -118,10 +247,8 @@ void expand(Path<typename G::state> const& path,
 	}
 
 	// if path is not terminal, then the U-bound requirement failed
+	sag::expand_all<G>(graph, rules, end_state);
 	for (auto action : graph.actions_at(end_state)) {
-		if (!graph.is_expanded_at(end_state, action))
-			sag::expand<G>(graph, rules, end_state, action);
-
 		for (ActionEdge edge : graph.edges_at(end_state, action)) {
 			// init the stats entry only if needed - remember the state might have been initialized by another parent!
 			if (!stats.has(edge.state()))
@@ -155,7 +282,7 @@ template <Graph G>
 	tools::NonNegative explore_constant) -> float {
 	float value_estimate = 0.0;
 	int action_visits = 0;
-	for (auto egde : graph.edges_at(state, action)) {
+	for (auto const& egde : graph.edges_view_at(state, action)) {
 		value_estimate += (egde.weight().value() * stats.at(egde.state()).Q);
 		action_visits += stats.at(egde.state()).N;
 	}
@@ -171,21 +298,61 @@ auto random_rollout(typename G::state state,
 	std::function<tools::UnitValue(void)>& random_source) -> tools::Score {
 	int rollout_length = 0;
 	while (!graph.is_terminal_at(state)) {
-		// pick a random action, expand and follow
-		auto actions = graph.actions_at(state);
-		size_t index = std::min(actions.size() - 1,
-			static_cast<size_t>(std::floor(static_cast<float>(actions.size()) * random_source().value())));
-		typename G::action action = actions[index];
+		// pick a random action, expand and follow (the expansion invalidates the actions view)
+		typename G::action action{};
+		{
+			auto const actions = graph.actions_view_at(state);
+			size_t index = std::min(actions.size() - 1,
+				static_cast<size_t>(std::floor(static_cast<float>(actions.size()) * random_source().value())));
+			action = actions[index];
+		}
 		if (!graph.is_expanded_at(state, action)) {
 			sag::expand<G>(graph, rules, state, action);
 		}
-		state = sag::follow(graph.edges_at(state, action), random_source());
+		state = sag::follow<G>(graph, state, action, random_source);
+		rollout_length++;
+	}
+	float value = (1 - 2 * static_cast<float>(rollout_length % 2)) * rules.score(state).value();
+	return tools::Score(value);
+}
+
+/// rules that can play a rollout on their own: actions into a buffer, applied in place
+template <typename G>
+concept GraphFreeRolloutGraph =
+	Graph<G> && InPlaceRulesEngine<typename G::rules, typename G::state, typename G::action> &&
+	BufferedRulesEngine<typename G::rules, typename G::state, typename G::action>;
+
+/// the same rollout as 'random_rollout' (same random source rolls give the same result), but played on the rules
+/// alone: the graph is not expanded and no memory is allocated
+template <GraphFreeRolloutGraph G>
+auto rules_rollout(typename G::state state,
+	typename G::rules const& rules,
+	std::function<tools::UnitValue(void)>& random_source) -> tools::Score {
+	int rollout_length = 0;
+	typename G::rules::action_buffer actions;
+	for (rules.list_actions_into(state, actions); !actions.empty(); rules.list_actions_into(state, actions)) {
+		size_t index = std::min(actions.size() - 1,
+			static_cast<size_t>(std::floor(static_cast<float>(actions.size()) * random_source().value())));
+		rules.apply(state, actions[index]);
 		rollout_length++;
 	}
 	float value = (1 - 2 * static_cast<float>(rollout_length % 2)) * rules.score(state).value();
 	return tools::Score(value);
 }
 
+/// the rollout used by default: graph-free if the rules allow, else on the graph
+template <Graph G>
+auto default_rollout(typename G::state state,
+	typename G::container& graph,
+	typename G::rules const& rules,
+	std::function<tools::UnitValue(void)>& random_source) -> tools::Score {
+	if constexpr (GraphFreeRolloutGraph<G>) {
+		return rules_rollout<G>(state, rules, random_source);
+	} else {
+		return random_rollout<G>(state, graph, rules, random_source);
+	}
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 //			Base MCTS implementation
 // --------------------------------------------------------------------------------------------------------------------
@@ -221,13 +388,39 @@ class BaseMCTS {
 
 		std::function<tools::Score(typename G::state)> initial_value_estimate =
 			[&](typename G::state start_state) -> tools::Score {
-			return random_rollout<G>(start_state, graph, rules, random_source);
+			return default_rollout<G>(start_state, graph, rules, random_source);
 		};
 
 		mcts_run<G>(
 			state, stats, graph, rules, sample_actions_uniformly_, U_bound_lambda, random_source, initial_value_estimate);
 	}
 
+	/// descend on node ids: states are only hashed to find the start node and to expand
+	auto descend(typename G::state state,
+		NodeStatistics& stats,
+		typename G::container& graph,
+		typename G::rules const& rules) -> void
+		requires NodeIndexedGraph<G>
+	{
+		std::function<tools::UnitValue(void)> random_source = [this]() -> tools::UnitValue {
+			return tools::UnitValue(unit_distribution_(rng_));
+		};
+		std::function<float(NodeId, size_t)> const upper_confidence_bound = [&](NodeId node, size_t action_index) {
+			return upper_confidence_bound_by_node<G>(node, action_index, graph, stats, explore_constant_);
+		};
+		std::function<tools::Score(NodeId)> const initial_value_estimate = [&](NodeId node) -> tools::Score {
+			return default_rollout<G>(graph.state_of(node), graph, rules, random_source);
+		};
+
+		NodeId const node = graph.node_of(state);
+		if (!stats.has(node))
+			stats.initialize(node, rules.score(state));
+		auto const path =
+			select_by_node<G>(node, stats, graph, sample_actions_uniformly_, upper_confidence_bound, random_source);
+		expand_by_node<G>(path, stats, graph, rules, initial_value_estimate);
+		update<NodeId>(path, stats);
+	}
+
  private:
 	bool sample_actions_uniformly_ = false;
 	tools::NonNegative explore_constant_{1.0F};
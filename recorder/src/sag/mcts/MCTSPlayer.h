@@ -87,7 +87,7 @@ class MCTSPlayer : public match::ProbabilisticPlayer<G> {
 
  private:
 	BaseMCTS<G> mcts_;
-	Statistics<typename G::state> stats_ = {};
+	StatisticsFor<G> stats_ = {};
 	size_t simulations_ = 1;
 
 	/// The exponent applied to action estimates when choosing the play. Nullopt (the default) means taking the best (no
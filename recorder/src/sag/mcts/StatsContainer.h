@@ -1,5 +1,7 @@
 #pragma once
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include "sag/GraphConcepts.h"
 
@@ -56,4 +58,40 @@ class Statistics {
 
 static_assert(StatsContainer<Statistics<int>, int>);
 
+/// Statistics in a flat array, indexed by the dense node ids of a 'NodeIndexedGraphContainer' (no hashing)
+class NodeStatistics {
+ public:
+	[[nodiscard]] auto at(NodeId node) const -> StatsEntry { return data_.at(node).value(); }
+	[[nodiscard]] auto has(NodeId node) const -> bool { return node < data_.size() && data_[node].has_value(); }
+	[[nodiscard]] auto size() const -> size_t { return size_; }
+
+	/// keeps the capacity, for the statistics of the next search
+	auto clear() -> void {
+		data_.clear();
+		size_ = 0;
+	}
+	auto initialize(NodeId node, tools::Score q_value) -> void {
+		if (node >= data_.size())
+			data_.resize(node + 1);
+		if (!data_[node].has_value()) {
+			data_[node] = StatsEntry{.N = 0, .Q = q_value.value()};
+			++size_;
+		}
+	}
+	auto add_visit(NodeId node) -> void { data_.at(node).value().N++; }
+	auto add_visit_result(NodeId node, tools::Score end_value) -> void {
+		StatsEntry& entry = data_.at(node).value();
+		++entry.N;
+		entry.Q += (end_value.value() - entry.Q) / static_cast<float>(entry.N);
+	}
+
+	friend auto operator<=>(const NodeStatistics&, const NodeStatistics&) = default;
+
+ private:
+	std::vector<std::optional<StatsEntry>> data_;
+	size_t size_ = 0;
+};
+
+static_assert(StatsContainer<NodeStatistics, NodeId>);
+
 }  // namespace sag::mcts
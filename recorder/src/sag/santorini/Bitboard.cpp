@@ -0,0 +1,27 @@
+#include "Bitboard.h"
+
+#include "sag/GraphConcepts.h"
+
+namespace sag::santorini::bitboard {
+
+namespace {
+constexpr Dimensions small{.rows = 2, .cols = 2, .player_unit_count = 1};
+constexpr Dimensions full{.rows = 5, .cols = 5, .player_unit_count = 2};
+
+static_assert(std::regular<State<small>>);
+static_assert(std::regular<State<full>>);
+
+static_assert(sag::Vertices<State<full>, Action>);
+static_assert(sag::DeterministicRulesEngine<Rules<full>, State<full>, Action>);
+static_assert(sag::SuccessorListingRulesEngine<Rules<full>, State<full>, Action>);
+static_assert(sag::BufferedRulesEngine<Rules<full>, State<full>, Action>);
+static_assert(sag::CountingRulesEngine<Rules<full>, State<full>, Action>);
+static_assert(sag::InPlaceRulesEngine<Rules<full>, State<full>, Action>);
+static_assert(sag::VertexPrinter<Rules<full>, State<full>, Action>);
+
+static_assert(sag::Graph<Graph<small>>);
+static_assert(sag::Graph<Graph<full>>);
+
+}  // namespace
+
+}  // namespace sag::santorini::bitboard
@@ -0,0 +1,341 @@
+#pragma once
+
+#include <fmt/core.h>
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "sag/DefaultGraphContainer_v1.h"
+#include "sag/GraphConcepts.h"
+#include "sag/santorini/Graph.h"
+#include "sag/santorini/Santorini.h"
+#include "tools/Hashing.h"
+#include "tools/StaticVector.h"
+
+/// Santorini on bitboards: the board is a mask per height level (bit 'col + cols * row' for each position), units are
+/// position indices. Moves and builds are generated with bit operations on precomputed neighbor masks. Same game and
+/// same actions (in the same order) as 'sag::santorini::Rules', only the state representation differs.
+namespace sag::santorini::bitboard {
+
+using Mask = std::uint32_t;
+
+template <Dimensions dim>
+struct State {
+	static_assert(dim.position_count() <= 32, "bitboards are limited to 32 positions");  // NOLINT(*magic-numbers)
+	static constexpr size_t level_count = 4;
+
+	/// 'levels[k]': positions built higher than k, hence 'levels[3]' are the closed positions (domes)
+	std::array<Mask, level_count> levels{};
+	std::array<unsigned char, dim.player_unit_count> units_player{};
+	std::array<unsigned char, dim.player_unit_count> units_opponent{};
+
+	friend auto operator<=>(const State&, const State&) = default;
+
+	[[nodiscard]] auto hash() const -> size_t {
+		size_t hash = 0;
+		tools::hash_combine(hash, levels);
+		tools::hash_combine(hash, units_player);
+		tools::hash_combine(hash, units_opponent);
+		return hash;
+	}
+
+	[[nodiscard]] constexpr auto height_at(unsigned char index) const -> unsigned char {
+		Mask const bit = Mask{1} << index;
+		return static_cast<unsigned char>(static_cast<int>((levels[0] & bit) != 0) +
+																			static_cast<int>((levels[1] & bit) != 0) +
+																			static_cast<int>((levels[2] & bit) != 0) +
+																			static_cast<int>((levels[3] & bit) != 0));
+	}
+
+	/// raises the position by one level
+	constexpr auto build_at(unsigned char index) -> void {
+		Mask const bit = Mask{1} << index;
+		assert((levels[3] & bit) == 0);  // sanity check
+		for (Mask& level : levels) {
+			if ((level & bit) == 0) {
+				level |= bit;
+				return;
+			}
+		}
+	}
+};
+
+[[nodiscard]] constexpr auto index_of(Position position, size_t cols) -> unsigned char {
+	return static_cast<unsigned char>(position.col + cols * position.row);
+}
+
+[[nodiscard]] constexpr auto position_of(unsigned char index, size_t cols) -> Position {
+	return {.row = static_cast<unsigned char>(index / cols), .col = static_cast<unsigned char>(index % cols)};
+}
+
+/// conversion from the base-5 encoded state of 'sag::santorini::Rules'
+template <Dimensions dim>
+[[nodiscard]] auto to_bitboard(santorini::State<dim> const& state) -> State<dim> {
+	State<dim> result;
+	auto const board = Board<dim>::decode_base5(state.board_base5.to_ullong()).underlying_array();
+	for (size_t index = 0; index < board.size(); ++index) {
+		for (size_t level = 0; level < static_cast<size_t>(board[index]); ++level)
+			result.levels[level] |= Mask{1} << index;
+	}
+	for (size_t unit = 0; unit < dim.player_unit_count; ++unit) {
+		result.units_player[unit] = index_of(state.units_player[unit], dim.cols);
+		result.units_opponent[unit] = index_of(state.units_opponent[unit], dim.cols);
+	}
+	return result;
+}
+
+/// conversion to the base-5 encoded state of 'sag::santorini::Rules'
+template <Dimensions dim>
+[[nodiscard]] auto from_bitboard(State<dim> const& state) -> santorini::State<dim> {
+	std::array<BoardState, dim.position_count()> board{};
+	for (unsigned char index = 0; index < board.size(); ++index)
+		board[index] = static_cast<BoardState>(state.height_at(index));
+	std::array<Position, dim.player_unit_count> units_player{};
+	std::array<Position, dim.player_unit_count> units_opponent{};
+	for (size_t unit = 0; unit < dim.player_unit_count; ++unit) {
+		units_player[unit] = position_of(state.units_player[unit], dim.cols);
+		units_opponent[unit] = position_of(state.units_opponent[unit], dim.cols);
+	}
+	return {units_player, units_opponent, Board<dim>{board}};
+}
+
+template <Dimensions dim>
+class Rules {
+ public:
+	static constexpr bool is_deterministic = true;
+
+	/// concept RulesEngine:
+	[[nodiscard]] auto list_roots() const -> std::vector<State<dim>> {
+		// all placements of the units on distinct positions, each unit set ascending (as 'santorini::Rules')
+		std::vector<std::array<unsigned char, dim.player_unit_count>> placements;
+		std::array<unsigned char, dim.player_unit_count> units{};
+		auto place = [&placements, &units](auto& self, size_t unit, unsigned char first) -> void {
+			if (unit == dim.player_unit_count) {
+				placements.push_back(units);
+				return;
+			}
+			for (auto index = first; index + (dim.player_unit_count - unit) <= dim.position_count(); ++index) {
+				units[unit] = index;
+				self(self, unit + 1, static_cast<unsigned char>(index + 1));
+			}
+		};
+		place(place, 0, 0);
+
+		std::vector<State<dim>> result;
+		for (auto const& player_units : placements) {
+			for (auto const& opponent_units : placements) {
+				if ((units_mask(player_units) & units_mask(opponent_units)) == 0)
+					result.push_back({.levels = {}, .units_player = player_units, .units_opponent = opponent_units});
+			}
+		}
+		return result;
+	}
+
+	[[nodiscard]] auto list_actions(State<dim> const& state) const -> std::vector<Action> {
+		std::vector<Action> result;
+		append_actions(state, result);
+		return result;
+	}
+
+	[[nodiscard]] auto list_edges(State<dim> const& state, Action action) const -> std::vector<ActionEdge<State<dim>>> {
+		return {ActionEdge<State<dim>>(1.0, apply_move(state, action))};
+	}
+
+	/// concept BufferedRulesEngine: each unit moves to one of at most 8 neighbors and builds on one of theirs
+	using action_buffer = tools::StaticVector<Action, dim.player_unit_count * 8 * 8>;  // NOLINT(*magic-numbers)
+	using edge_buffer = tools::StaticVector<ActionEdge<State<dim>>, 1>;
+
+	auto list_actions_into(State<dim> const& state, action_buffer& actions) const -> void {
+		actions.clear();
+		append_actions(state, actions);
+	}
+
+	auto list_edges_into(State<dim> const& state, Action action, edge_buffer& edges) const -> void {
+		edges.clear();
+		edges.emplace_back(1.0F, apply_move(state, action));
+	}
+
+	/// concept InPlaceRulesEngine:
+	static auto apply(State<dim>& state, Action action) -> void {
+		state.units_player[action.unit_nr] = index_of(action.move_location, dim.cols);
+		state.build_at(index_of(action.build_location, dim.cols));
+		std::swap(state.units_player, state.units_opponent);
+	}
+
+	/// concept SuccessorListingRulesEngine:
+	[[nodiscard]] auto list_successors(State<dim> const& state) const -> ActionSuccessors<State<dim>, Action> {
+		ActionSuccessors<State<dim>, Action> result;
+		action_buffer actions;
+		append_actions(state, actions);
+		for (Action const& action : actions) {
+			result.emplace_back(
+				action, std::vector<ActionEdge<State<dim>>>{ActionEdge<State<dim>>(1.0, apply_move(state, action))});
+		}
+		return result;
+	}
+
+	[[nodiscard]] auto score(State<dim> const& state) const -> tools::Score {
+		return tools::Score{is_terminal(state) ? -1.0F : 0.0F};
+	}
+
+	/// concept CountingRulesEngine: a move with at least one build suffices, respectively a popcount per move
+	[[nodiscard]] auto is_terminal(State<dim> const& state) const -> bool {
+		if (opponent_has_won(state))
+			return true;
+		Mask const free = free_mask(state);
+		for (unsigned char const start_from : state.units_player) {
+			for (Mask moves = move_mask(state, start_from, free); moves != 0; moves &= moves - 1) {
+				if ((neighbors_[static_cast<size_t>(std::countr_zero(moves))] & free) != 0)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] auto action_count(State<dim> const& state) const -> size_t {
+		if (opponent_has_won(state))
+			return 0;
+		Mask const free = free_mask(state);
+		size_t result = 0;
+		for (unsigned char const start_from : state.units_player) {
+			for (Mask moves = move_mask(state, start_from, free); moves != 0; moves &= moves - 1)
+				result += static_cast<size_t>(std::popcount(neighbors_[static_cast<size_t>(std::countr_zero(moves))] & free));
+		}
+		return result;
+	}
+
+	/// concept VertexPrinter: same output as 'santorini::Rules'
+	[[nodiscard]] auto to_string(State<dim> const& state) const -> std::string {
+		int turn_nr = 0;
+		for (Mask const level : state.levels)
+			turn_nr += std::popcount(level);
+		bool const starting_player_turn = turn_nr % 2 == 0;
+
+		Mask const player = units_mask(state.units_player);
+		Mask const opponent = units_mask(state.units_opponent);
+		std::string result = "[";
+		for (unsigned char index = 0; index < dim.position_count(); ++index) {
+			if (index > 0 && index % dim.cols == 0)
+				result.append("][");
+			Mask const bit = Mask{1} << index;
+			char symbol = ' ';
+			if ((opponent & bit) != 0)
+				symbol = starting_player_turn ? 'o' : 'x';
+			else if ((player & bit) != 0)
+				symbol = starting_player_turn ? 'x' : 'o';
+			result.append(' ' + std::to_string(state.height_at(index)) + symbol);
+		}
+		result.append("]");
+		return result;
+	}
+
+	[[nodiscard]] auto to_string(State<dim> const& state, Action action) const -> std::string {
+		return fmt::format("({}->{}, build {}) on {}",
+			position_of(state.units_player[action.unit_nr], dim.cols).to_string(),
+			action.move_location.to_string(),
+			action.build_location.to_string(),
+			to_string(state));
+	}
+
+ private:
+	static constexpr std::array<Mask, dim.position_count()> neighbors_ = [] {
+		std::array<Mask, dim.position_count()> result{};
+		for (size_t row = 0; row < dim.rows; ++row) {
+			for (size_t col = 0; col < dim.cols; ++col) {
+				for (size_t other_row = row > 0 ? row - 1 : 0; other_row <= row + 1 && other_row < dim.rows; ++other_row) {
+					for (size_t other_col = col > 0 ? col - 1 : 0; other_col <= col + 1 && other_col < dim.cols; ++other_col) {
+						if (other_row != row || other_col != col)
+							result[col + dim.cols * row] |= Mask{1} << (other_col + dim.cols * other_row);
+					}
+				}
+			}
+		}
+		return result;
+	}();
+
+	[[nodiscard]] static constexpr auto units_mask(std::array<unsigned char, dim.player_unit_count> const& units)
+		-> Mask {
+		Mask result = 0;
+		for (unsigned char const unit : units)
+			result |= Mask{1} << unit;
+		return result;
+	}
+
+	/// appends the actions to 'result', a vector or an 'action_buffer'
+	template <typename Actions>
+	auto append_actions(State<dim> const& state, Actions& result) const -> void {
+		if (opponent_has_won(state))
+			return;
+
+		Mask const free = free_mask(state);
+		for (size_t unit_nr = 0; unit_nr < dim.player_unit_count; ++unit_nr) {
+			unsigned char const start_from = state.units_player[unit_nr];
+			for (Mask moves = move_mask(state, start_from, free); moves != 0; moves &= moves - 1) {
+				auto const move_to = static_cast<unsigned char>(std::countr_zero(moves));
+				for (Mask builds = neighbors_[move_to] & free; builds != 0; builds &= builds - 1) {
+					auto const build_at = static_cast<unsigned char>(std::countr_zero(builds));
+					result.push_back(Action{.unit_nr = static_cast<unsigned char>(unit_nr),
+						.move_location = position_of(move_to, dim.cols),
+						.build_location = position_of(build_at, dim.cols)});
+				}
+			}
+		}
+	}
+
+	/// positions neither occupied by a unit nor closed
+	[[nodiscard]] static auto free_mask(State<dim> const& state) -> Mask {
+		return ~(units_mask(state.units_player) | units_mask(state.units_opponent) | state.levels[3]);
+	}
+
+	/// free neighbors of the unit climbing at most one level
+	[[nodiscard]] static auto move_mask(State<dim> const& state, unsigned char start_from, Mask free) -> Mask {
+		unsigned char const height = state.height_at(start_from);
+		assert(height < 3);  // a player unit on level 3 has won, which ends the game before its next turn
+		return neighbors_[start_from] & free & ~state.levels[height + 1];
+	}
+
+	[[nodiscard]] static auto opponent_has_won(State<dim> const& state) -> bool {
+		Mask const goals = state.levels[2] & ~state.levels[3];
+		// can not be reached from walking down a graph (state gets inverted, to reflect the *active* players view)
+		assert((units_mask(state.units_player) & goals) == 0);
+		return (units_mask(state.units_opponent) & goals) != 0;
+	}
+
+	[[nodiscard]] static auto apply_move(State<dim> state, Action action) -> State<dim> {
+		apply(state, action);
+		return state;
+	}
+};
+
+template <Dimensions dim>
+struct Container : public DefaultGraphContainer_v1<State<dim>, Action> {
+	Container() : DefaultGraphContainer_v1<State<dim>, Action>(Rules<dim>()) {}
+};
+
+template <Dimensions dim>
+struct Graph {
+	using state = State<dim>;
+	using action = Action;
+	using container = Container<dim>;
+	using rules = Rules<dim>;
+	using printer = Rules<dim>;
+};
+
+}  // namespace sag::santorini::bitboard
+
+namespace std {
+
+template <sag::santorini::Dimensions dim>
+// NOLINTNEXTLINE(cert-dcl58-cpp)
+struct hash<sag::santorini::bitboard::State<dim>> {
+	auto operator()(sag::santorini::bitboard::State<dim> const& state) const noexcept -> std::size_t {
+		return state.hash();
+	}
+};
+
+}  // namespace std
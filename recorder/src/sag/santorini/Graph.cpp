@@ -14,6 +14,10 @@ static_assert(std::regular<State<small>>);
 static_assert(sag::Vertices<State<small>, Action>);
 static_assert(sag::RulesEngine<Rules<small>, State<small>, Action>);
 static_assert(sag::VertexPrinter<Rules<small>, State<small>, Action>);
+static_assert(sag::BufferedRulesEngine<Rules<small>, State<small>, Action>);
+static_assert(sag::CountingRulesEngine<Rules<small>, State<small>, Action>);
+static_assert(sag::InPlaceRulesEngine<Rules<small>, State<small>, Action>);
+static_assert(sag::Symmetry<Symmetry<small>, State<small>, Action>);
 
 static_assert(sag::Graph<Graph<small>>);
 
@@ -3,49 +3,192 @@
 #include <fmt/core.h>
 
 #include <algorithm>
+#include <bit>
 #include <bitset>
 #include <cassert>
 #include <concepts>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <numeric>
 #include <ranges>
 #include <stdexcept>
 #include <string>
+#include <tuple>
+#include <utility>
 
 #include "Santorini.h"
+#include "sag/BudgetedGraphContainer.h"
+#include "sag/CanonicalRules.h"
 #include "sag/DefaultGraphContainer_v1.h"
+#include "sag/FrozenGraphContainer.h"
 #include "sag/santorini/Santorini.h"
 #include "sag/storage/SQLiteMatchStorage.h"
 #include "tools/Hashing.h"
+#include "tools/StaticVector.h"
 
 namespace sag::santorini {
+
+/// Random keys for Zobrist hashing of states: the key of a state is the xor of the keys of the height of each position
+/// and of the position of each unit, per owner and unit number (as the unit numbers are part of a state). Moves and
+/// builds hence update a key by a few xors.
+template <Dimensions dim>
+class ZobristKeys {
+ public:
+	using Key = std::uint64_t;
+	using Units = std::array<Position, dim.player_unit_count>;
+	static constexpr size_t player = 0;
+	static constexpr size_t opponent = 1;
+
+	[[nodiscard]] static constexpr auto height(Position position, BoardState height) -> Key {
+		return heights_[index_of(position)][static_cast<size_t>(height)];
+	}
+
+	[[nodiscard]] static constexpr auto unit(size_t owner, size_t unit_nr, Position position) -> Key {
+		return units_[owner][unit_nr][index_of(position)];
+	}
+
+	/// the change of the key when the units of the player and of the opponent trade their owners
+	[[nodiscard]] static constexpr auto swap_owners(Units const& units_player, Units const& units_opponent) -> Key {
+		Key result = 0;
+		for (size_t unit_nr = 0; unit_nr < dim.player_unit_count; ++unit_nr) {
+			result ^= unit(player, unit_nr, units_player[unit_nr]) ^ unit(opponent, unit_nr, units_player[unit_nr]);
+			result ^= unit(player, unit_nr, units_opponent[unit_nr]) ^ unit(opponent, unit_nr, units_opponent[unit_nr]);
+		}
+		return result;
+	}
+
+	/// the key of a state computed from scratch
+	[[nodiscard]] static constexpr auto key_of(
+		Units const& units_player, Units const& units_opponent, unsigned long long encoded_board_base5) -> Key {
+		Key result = 0;
+		for (auto& position_heights : heights_) {
+			result ^= position_heights[encoded_board_base5 % position_heights.size()];
+			encoded_board_base5 /= position_heights.size();
+		}
+		for (size_t unit_nr = 0; unit_nr < dim.player_unit_count; ++unit_nr)
+			result ^= unit(player, unit_nr, units_player[unit_nr]) ^ unit(opponent, unit_nr, units_opponent[unit_nr]);
+		return result;
+	}
+
+ private:
+	static constexpr auto index_of(Position position) -> size_t { return position.col + dim.cols * position.row; }
+
+	/// splitmix64, a fixed seed for the same keys in every build
+	static constexpr auto next_key(Key& seed) -> Key {
+		// NOLINTBEGIN(*magic-numbers)
+		Key result = (seed += 0x9E3779B97F4A7C15ULL);
+		result = (result ^ (result >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+		result = (result ^ (result >> 27U)) * 0x94D049BB133111EBULL;
+		return result ^ (result >> 31U);
+		// NOLINTEND(*magic-numbers)
+	}
+
+	static constexpr Key seed_ = 0x5A4E'7031'2D5A'4F42ULL;  // NOLINT(*magic-numbers)
+
+	/// the ground (height 0) has key 0, such that an empty board does not contribute to the key
+	static constexpr auto heights_ = [] {
+		Key seed = seed_;
+		std::array<std::array<Key, static_cast<size_t>(BoardState::VALUE_COUNT)>, dim.position_count()> result{};
+		for (auto& position_heights : result) {
+			for (size_t height = 1; height < position_heights.size(); ++height)
+				position_heights[height] = next_key(seed);
+		}
+		return result;
+	}();
+
+	static constexpr auto units_ = [] {
+		Key seed = ~seed_;
+		std::array<std::array<std::array<Key, dim.position_count()>, dim.player_unit_count>, 2> result{};
+		for (auto& owner_units : result) {
+			for (auto& unit_positions : owner_units) {
+				for (Key& key : unit_positions)
+					key = next_key(seed);
+			}
+		}
+		return result;
+	}();
+};
+
 template <Dimensions dim>
 struct State {
-	State() = default;
-	State(std::array<Position, dim.player_unit_count> player_units,
+	constexpr State() : State({}, {}, 0ULL) {}
+	constexpr State(std::array<Position, dim.player_unit_count> player_units,
 		std::array<Position, dim.player_unit_count> opponent_units,
 		unsigned long long encoded_board_base5)
 			: units_player(std::move(player_units)),
 				units_opponent(std::move(opponent_units)),
-				board_base5(encoded_board_base5) {}
+				board_base5(encoded_board_base5),
+				zobrist_key(ZobristKeys<dim>::key_of(units_player, units_opponent, encoded_board_base5)) {}
 
 	State(std::array<Position, dim.player_unit_count> player_units,
 		std::array<Position, dim.player_unit_count> opponent_units,
 		Board<dim> board)
 			: State(player_units, opponent_units, board.encode_base5()) {}
 
-	friend auto operator<=>(const State&, const State&) = default;
+	/// compares the game only, the key follows from it
+	friend auto operator==(const State& left, const State& right) -> bool {
+		return left.units_player == right.units_player && left.units_opponent == right.units_opponent &&
+					 left.board_base5 == right.board_base5;
+	}
 
+	/// the Zobrist key, at no cost (debug builds check that it is in sync)
 	[[nodiscard]] auto hash() const -> size_t {
-		size_t hash = std::hash<std::bitset<dim.encoded_board_bitcount()>>()(board_base5);
-		tools::hash_combine(hash, units_player);
-		tools::hash_combine(hash, units_opponent);
-		return hash;
+		assert(zobrist_key == ZobristKeys<dim>::key_of(units_player, units_opponent, board_base5.to_ullong()));
+		return zobrist_key;
 	}
 
 	std::array<Position, dim.player_unit_count> units_player;
 	std::array<Position, dim.player_unit_count> units_opponent;
 	std::bitset<dim.encoded_board_bitcount()> board_base5;
+	/// Zobrist key of the members above (see 'ZobristKeys'), updated incrementally by moves: edits of the members
+	/// require a new state (by the constructors) to keep it in sync
+	std::uint64_t zobrist_key = 0;
+};
+
+/// Hit statistics of a cache
+struct CacheStats {
+	size_t hits = 0;
+	size_t misses = 0;
+
+	[[nodiscard]] auto hit_rate() const -> double {
+		return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+	}
+
+	friend auto operator<=>(const CacheStats&, const CacheStats&) = default;
+};
+
+/// Direct-mapped cache of decoded boards by their base-5 encoding: a hit costs a hash and a compare, a miss decodes
+/// and overwrites the single entry the encoding maps to. Not synchronized, hence used per thread (see 'Rules').
+template <Dimensions dim>
+class BoardCache {
+ public:
+	static constexpr size_t entry_count = 1024;
+
+	[[nodiscard]] auto get(unsigned long long encoded_value) -> Board<dim> const& {
+		constexpr std::uint64_t golden_ratio = 0x9E3779B97F4A7C15ULL;
+		constexpr auto shift = static_cast<unsigned>(64 - std::countr_zero(entry_count));
+		Entry& entry = entries_[(std::uint64_t{encoded_value} * golden_ratio) >> shift];
+		if (entry.encoded_value == encoded_value) {
+			++stats_.hits;
+		} else {
+			++stats_.misses;
+			entry = {.encoded_value = encoded_value, .board = Board<dim>::decode_base5(encoded_value)};
+		}
+		return entry.board;
+	}
+
+	[[nodiscard]] auto stats() const -> CacheStats { return stats_; }
+
+ private:
+	struct Entry {
+		unsigned long long encoded_value = no_value;  // no board encodes to the maximum, it exceeds 5^27
+		Board<dim> board;
+	};
+	static constexpr unsigned long long no_value = std::numeric_limits<unsigned long long>::max();
+
+	std::vector<Entry> entries_ = std::vector<Entry>(entry_count);
+	CacheStats stats_;
 };
 
 struct Action {
@@ -58,6 +201,9 @@ struct Action {
 template <Dimensions dim>
 class Rules {
  public:
+	static constexpr bool is_deterministic = true;
+	using Units = std::array<Position, dim.player_unit_count>;
+
 	Rules() = default;
 
 	/// concept RulesEngine:
@@ -79,49 +225,77 @@ class Rules {
 	}
 
 	[[nodiscard]] auto list_actions(State<dim> state) const -> std::vector<Action> {
-		if (opponent_has_won(state))
-			return {};
-
 		std::vector<Action> result;
-		Board<dim> const board = get_board(state);
+		list_actions(state, get_board(state), result);
+		return result;
+	}
 
-		auto is_free = [&state, &board](Position pos) {
-			return std::ranges::find(state.units_player, pos) == state.units_player.end() &&
-						 std::ranges::find(state.units_opponent, pos) == state.units_opponent.end() &&
-						 board.at(pos) != BoardState::Closed;
-		};
+	[[nodiscard]] auto list_edges(State<dim> state, Action action) const -> std::vector<sag::ActionEdge<State<dim>>> {
+		return {ActionEdge<State<dim>>(1.0, apply_move(state, get_board(state), action))};
+	}
 
-		for (size_t unit_nr = 0; unit_nr < state.units_player.size(); ++unit_nr) {
-			Position const start_from = state.units_player[unit_nr];
+	/// concept BufferedRulesEngine: each unit moves to one of at most 8 neighbors and builds on one of theirs
+	using action_buffer = tools::StaticVector<Action, dim.player_unit_count * 8 * 8>;  // NOLINT(*magic-numbers)
+	using edge_buffer = tools::StaticVector<ActionEdge<State<dim>>, 1>;
 
-			auto valid_moves =
-				neighborhoods_.at(start_from) | std::views::filter([&board, &is_free, &start_from](Position move_to) {
-					return is_free(move_to) &&
-								 static_cast<unsigned char>(board.at(move_to)) < 2 + static_cast<unsigned char>(board.at(start_from));
-				});
+	auto list_actions_into(State<dim> state, action_buffer& actions) const -> void {
+		actions.clear();
+		list_actions(state, get_board(state), actions);
+	}
 
-			auto valid_builds = [&start_from, &is_free, this](Position move_to) {
-				return neighborhoods_.at(move_to) | std::views::filter([&is_free, &start_from](Position build_at) {
-					return start_from != build_at && is_free(build_at);
-				});
-			};
+	auto list_edges_into(State<dim> state, Action action, edge_buffer& edges) const -> void {
+		edges.clear();
+		edges.emplace_back(1.0F, apply_move(state, get_board(state), action));
+	}
 
-			for (Position move_to : valid_moves) {
-				for (Position build_at : valid_builds(move_to)) {
-					result.emplace_back(Action{
-						.unit_nr = static_cast<unsigned char>(unit_nr), .move_location = move_to, .build_location = build_at});
-				}
-			}
+	/// concept InPlaceRulesEngine: reads the height at the build location from the encoding, without the board
+	auto apply(State<dim>& state, Action action) const -> void {
+		move_and_build(state, Board<dim>::decode_base5_at(state.board_base5.to_ullong(), action.build_location), action);
+	}
+
+	/// concept SuccessorListingRulesEngine: decodes the board once for all actions
+	[[nodiscard]] auto list_successors(State<dim> state) const -> ActionSuccessors<State<dim>, Action> {
+		Board<dim> const board = get_board(state);
+		ActionSuccessors<State<dim>, Action> result;
+		action_buffer actions;
+		list_actions(state, board, actions);
+		for (Action const& action : actions) {
+			result.emplace_back(
+				action, std::vector<ActionEdge<State<dim>>>{ActionEdge<State<dim>>(1.0, apply_move(state, board, action))});
 		}
 		return result;
 	}
 
-	[[nodiscard]] auto list_edges(State<dim> state, Action action) const -> std::vector<sag::ActionEdge<State<dim>>> {
-		return {ActionEdge<State<dim>>(1.0, apply_move(state, action))};
+	[[nodiscard]] auto score(State<dim> state) const -> tools::Score {
+		return tools::Score{is_terminal(state) ? -1.0F : 0.0F};
 	}
 
-	[[nodiscard]] auto score(State<dim> state) const -> tools::Score {
-		return tools::Score{list_actions(state).empty() ? -1.0F : 0.0F};
+	/// concept CountingRulesEngine: stops at the first action, respectively counts without listing
+	[[nodiscard]] auto is_terminal(State<dim> state) const -> bool {
+		return visit_actions(state.units_player, state.units_opponent, get_board(state), [](Action const& /*unused*/) {
+			return false;
+		});
+	}
+
+	[[nodiscard]] auto action_count(State<dim> state) const -> size_t {
+		size_t result = 0;
+		visit_actions(state.units_player, state.units_opponent, get_board(state), [&result](Action const& /*unused*/) {
+			++result;
+			return true;
+		});
+		return result;
+	}
+
+	/// Calls the visitor with each action of the state of these units and encoded board (in the order of
+	/// 'list_actions') until it returns false, returns whether all actions were visited. For other encodings of states,
+	/// which need neither a 'State' nor its Zobrist key (see 'PackedRules').
+	template <std::predicate<Action const&> Visitor>
+	auto visit_actions(Units const& units_player,
+		Units const& units_opponent,
+		unsigned long long encoded_board_base5,
+		Visitor&& visitor) const -> bool {
+		Board<dim> const board = board_cache().get(encoded_board_base5);
+		return visit_actions(units_player, units_opponent, board, std::forward<Visitor>(visitor));
 	}
 
 	/// concept VertexPrinter:
@@ -166,33 +340,102 @@ class Rules {
 			to_string(state));
 	}
 
+	/// hits and misses of the decoded boards of the calling thread (shared by all rules of its dimensions)
+	[[nodiscard]] static auto board_cache_stats() -> CacheStats { return board_cache().stats(); }
+
  private:
 	std::map<Position, std::vector<Position>> neighborhoods_ = create_neighborhoods();
 	std::vector<Position> sorted_positions_ = create_sorted_positions();
 
+	/// one cache per thread: rules may be copied into and used by several threads without synchronization
+	static auto board_cache() -> BoardCache<dim>& {
+		thread_local BoardCache<dim> cache;
+		return cache;
+	}
+
 	// get the board for the given state, possibly from cache
-	auto get_board(State<dim> state) const -> Board<dim> {
-		return Board<dim>::decode_base5(state.board_base5.to_ullong());
+	auto get_board(State<dim> state) const -> Board<dim> { return board_cache().get(state.board_base5.to_ullong()); }
+
+	/// appends the actions to 'result', a vector or an 'action_buffer'
+	template <typename Actions>
+	auto list_actions(State<dim> state, Board<dim> const& board, Actions& result) const -> void {
+		visit_actions(state.units_player, state.units_opponent, board, [&result](Action const& action) {
+			result.push_back(action);
+			return true;
+		});
 	}
 
-	auto opponent_has_won(State<dim> state) const -> bool {
-		Board<dim> const board = get_board(state);
+	/// as the public 'visit_actions', on the decoded board
+	template <std::predicate<Action const&> Visitor>
+	auto visit_actions(
+		Units const& units_player, Units const& units_opponent, Board<dim> const& board, Visitor&& visitor) const -> bool {
+		if (opponent_has_won(units_player, units_opponent, board))
+			return true;
+
+		auto is_free = [&units_player, &units_opponent, &board](Position pos) {
+			return std::ranges::find(units_player, pos) == units_player.end() &&
+						 std::ranges::find(units_opponent, pos) == units_opponent.end() && board.at(pos) != BoardState::Closed;
+		};
+
+		for (size_t unit_nr = 0; unit_nr < units_player.size(); ++unit_nr) {
+			Position const start_from = units_player[unit_nr];
+
+			auto valid_moves =
+				neighborhoods_.at(start_from) | std::views::filter([&board, &is_free, &start_from](Position move_to) {
+					return is_free(move_to) &&
+								 static_cast<unsigned char>(board.at(move_to)) < 2 + static_cast<unsigned char>(board.at(start_from));
+				});
+
+			auto valid_builds = [&start_from, &is_free, this](Position move_to) {
+				return neighborhoods_.at(move_to) | std::views::filter([&is_free, &start_from](Position build_at) {
+					return start_from != build_at && is_free(build_at);
+				});
+			};
+
+			for (Position move_to : valid_moves) {
+				for (Position build_at : valid_builds(move_to)) {
+					if (!visitor(Action{
+								.unit_nr = static_cast<unsigned char>(unit_nr), .move_location = move_to, .build_location = build_at}))
+						return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	auto opponent_has_won(
+		[[maybe_unused]] Units const& units_player, Units const& units_opponent, Board<dim> const& board) const -> bool {
 		auto unit_has_won = [&board](Position unit) {
 			return board.at(unit) == BoardState::Goal;
 		};
 
 		// can not be reached from walking down a graph (state gets inverted, to refelct the *active* players view)
-		assert(std::ranges::none_of(state.units_player, unit_has_won));
+		assert(std::ranges::none_of(units_player, unit_has_won));
+
+		return std::ranges::any_of(units_opponent, unit_has_won);
+	}
 
-		return std::ranges::any_of(state.units_opponent, unit_has_won);
+	auto apply_move(State<dim> state, Board<dim> const& board, Action action) const -> State<dim> {
+		move_and_build(state, board.at(action.build_location), action);
+		return state;
 	}
 
-	auto apply_move(State<dim> state, Action action) const -> State<dim> {
-		Board<dim> board = get_board(state);
-		state.units_player[action.unit_nr] = action.move_location;
-		board.increment(action.build_location);
+	/// updates the encoded board and the Zobrist key incrementally, instead of encoding and hashing from scratch
+	static auto move_and_build(State<dim>& state, BoardState height, Action action) -> void {
+		using Keys = ZobristKeys<dim>;
+		Position& unit = state.units_player[action.unit_nr];
+		state.zobrist_key ^= Keys::unit(Keys::player, action.unit_nr, unit) ^
+												 Keys::unit(Keys::player, action.unit_nr, action.move_location);
+		unit = action.move_location;
+
+		assert(height != BoardState::Closed);  // sanity check
+		auto const raised = static_cast<BoardState>(static_cast<unsigned char>(height) + 1);
+		state.zobrist_key ^= Keys::height(action.build_location, height) ^ Keys::height(action.build_location, raised);
+		state.board_base5 = state.board_base5.to_ullong() +
+												Board<dim>::powers_of_5[action.build_location.col + dim.cols * action.build_location.row];
+
+		state.zobrist_key ^= Keys::swap_owners(state.units_player, state.units_opponent);
 		std::swap(state.units_player, state.units_opponent);
-		return {state.units_player, state.units_opponent, board};
 	}
 
 	auto recurse_unit_combinations(size_t unit_index, size_t position_index) const
@@ -256,6 +499,45 @@ class Rules {
 	}
 };
 
+/// the rotations and reflections of the board (only reflections and the half turn if it is not square), e.g. for
+/// 'CanonicalRules<Rules<dim>, Symmetry<dim>>'. Units keep their numbers, hence transformed actions their 'unit_nr'.
+template <Dimensions dim>
+struct Symmetry {
+	using Grid = GridSymmetries<dim.rows, dim.cols>;
+	static constexpr size_t transform_count = Grid::transform_count;
+
+	[[nodiscard]] static auto transform_state(State<dim> state, size_t transform) -> State<dim> {
+		auto const board = Board<dim>::decode_base5(state.board_base5.to_ullong()).underlying_array();
+		std::array<BoardState, dim.position_count()> transformed{};
+		for (size_t index = 0; index < board.size(); ++index)
+			transformed[Grid::permutations[transform][index]] = board[index];
+		for (Position& unit : state.units_player)
+			unit = transform_position(unit, transform);
+		for (Position& unit : state.units_opponent)
+			unit = transform_position(unit, transform);
+		return {state.units_player, state.units_opponent, Board<dim>{transformed}};
+	}
+
+	[[nodiscard]] static auto transform_action(Action action, size_t transform) -> Action {
+		action.move_location = transform_position(action.move_location, transform);
+		action.build_location = transform_position(action.build_location, transform);
+		return action;
+	}
+
+	[[nodiscard]] static auto inverse(size_t transform) -> size_t { return Grid::inverses[transform]; }
+
+	[[nodiscard]] static auto precedes(State<dim> const& lhs, State<dim> const& rhs) -> bool {
+		return std::tuple(lhs.board_base5.to_ullong(), lhs.units_player, lhs.units_opponent) <
+					 std::tuple(rhs.board_base5.to_ullong(), rhs.units_player, rhs.units_opponent);
+	}
+
+ private:
+	[[nodiscard]] static constexpr auto transform_position(Position position, size_t transform) -> Position {
+		size_t const index = Grid::permutations[transform][position.col + dim.cols * position.row];
+		return {.row = static_cast<unsigned char>(index / dim.cols), .col = static_cast<unsigned char>(index % dim.cols)};
+	}
+};
+
 template <Dimensions dim>
 struct Container : public DefaultGraphContainer_v1<State<dim>, Action> {
 	Container() : DefaultGraphContainer_v1<State<dim>, Action>(Rules<dim>()) {}
@@ -270,6 +552,24 @@ struct Graph {
 	using printer = Rules<dim>;  // resuse rules as printer, thereby sharing caching of `get_board`
 };
 
+template <Dimensions dim>
+struct BudgetedContainer : public BudgetedGraphContainer<State<dim>, Action> {
+	explicit BudgetedContainer(size_t byte_budget = BudgetedGraphContainer<State<dim>, Action>::unlimited)
+			: BudgetedGraphContainer<State<dim>, Action>(Rules<dim>(), byte_budget) {}
+};
+
+/// Graph with a memory-budgeted container, for long running recordings
+template <Dimensions dim>
+struct BudgetedGraph : public Graph<dim> {
+	using container = BudgetedContainer<dim>;
+};
+
+/// Graph on a frozen graph file of all reachable states (see 'freeze_graph' and the freezer tool)
+template <Dimensions dim>
+struct FrozenGraph : public Graph<dim> {
+	using container = FrozenGraphContainer<State<dim>, Action>;
+};
+
 template <Dimensions dim>
 struct StateConverter {
 	static_assert(dim.cols < 10, "position-to-string conversion (has no padding) requires values in [0,9]");  // NOLINT
@@ -0,0 +1,41 @@
+#include "Packed.h"
+
+#include "sag/GraphConcepts.h"
+
+namespace sag::santorini {
+
+namespace {
+constexpr Dimensions small{.rows = 2, .cols = 2, .player_unit_count = 1};
+constexpr Dimensions full{.rows = 5, .cols = 5, .player_unit_count = 2};
+
+static_assert(sizeof(PackedState<full>) == 16);
+static_assert(sizeof(PackedAction<full>) == 2);
+static_assert(sag::Identifier<PackedState<full>>);
+static_assert(sag::Identifier<PackedAction<full>>);
+
+// constexpr round trips
+constexpr std::array<Position, 2> units_player{Position{0, 1}, Position{4, 4}};
+constexpr std::array<Position, 2> units_opponent{Position{2, 3}, Position{3, 0}};
+constexpr unsigned long long largest_board = 298'023'223'876'953'124ULL;  // 5^25-1
+constexpr auto packed_state = PackedState<full>::pack(units_player, units_opponent, largest_board);
+static_assert(packed_state.units_player() == units_player);
+static_assert(packed_state.units_opponent() == units_opponent);
+static_assert(packed_state.board_base5() == largest_board);
+static_assert(packed_state.unpack().units_player == units_player);
+static_assert(
+	packed_state.unpack().zobrist_key == ZobristKeys<full>::key_of(units_player, units_opponent, largest_board));
+
+constexpr Action action{.unit_nr = 1, .move_location = {4, 3}, .build_location = {3, 2}};
+static_assert(PackedAction<full>::pack(action).unpack() == action);
+
+static_assert(sag::DeterministicRulesEngine<PackedRules<full>, PackedState<full>, PackedAction<full>>);
+static_assert(sag::SuccessorListingRulesEngine<PackedRules<full>, PackedState<full>, PackedAction<full>>);
+static_assert(sag::CountingRulesEngine<PackedRules<full>, PackedState<full>, PackedAction<full>>);
+static_assert(sag::VertexPrinter<PackedRules<full>, PackedState<full>, PackedAction<full>>);
+
+static_assert(sag::Graph<PackedGraph<small>>);
+static_assert(sag::Graph<PackedGraph<full>>);
+
+}  // namespace
+
+}  // namespace sag::santorini
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sag/DefaultGraphContainer_v1.h"
+#include "sag/GraphConcepts.h"
+#include "sag/GraphOperations.h"
+#include "sag/santorini/Graph.h"
+#include "sag/santorini/Santorini.h"
+#include "tools/Hashing.h"
+
+/// Compact encodings of Santorini states (128 bits) and actions (16 bits), for smaller graph and statistics nodes and
+/// cheaper copies than 'State' and 'Action'. Units are encoded by 5-bit position indices 'col + cols * row'. Packed
+/// states store no Zobrist key, they hash their two words (which have no padding bytes) instead.
+namespace sag::santorini {
+
+/// A state packed into two words: the base-5 encoded board in the first (59 bits suffice for 25 positions), the
+/// units of the player followed by the units of the opponent in the second.
+template <Dimensions dim>
+class PackedState {
+ public:
+	static constexpr std::uint64_t unit_bits = 5;
+	static_assert(dim.position_count() <= 25, "the base-5 board is limited to 59 bits");  // NOLINT(*magic-numbers)
+	static_assert(2 * dim.player_unit_count * unit_bits <= 64, "the units are limited to 64 bits");  // NOLINT
+
+	using Units = std::array<Position, dim.player_unit_count>;
+
+	constexpr PackedState() = default;
+
+	[[nodiscard]] static constexpr auto pack(
+		Units const& units_player, Units const& units_opponent, unsigned long long encoded_board_base5) -> PackedState {
+		PackedState result;
+		result.words_[0] = encoded_board_base5;
+		for (size_t unit_nr = 0; unit_nr < dim.player_unit_count; ++unit_nr) {
+			result.words_[1] |= index_of(units_player[unit_nr]) << (unit_nr * unit_bits);
+			result.words_[1] |= index_of(units_opponent[unit_nr]) << ((dim.player_unit_count + unit_nr) * unit_bits);
+		}
+		return result;
+	}
+
+	[[nodiscard]] static auto pack(State<dim> const& state) -> PackedState {
+		return pack(state.units_player, state.units_opponent, state.board_base5.to_ullong());
+	}
+
+	[[nodiscard]] constexpr auto board_base5() const -> unsigned long long { return words_[0]; }
+	[[nodiscard]] constexpr auto units_player() const -> Units { return units_at(0); }
+	[[nodiscard]] constexpr auto units_opponent() const -> Units { return units_at(dim.player_unit_count); }
+
+	[[nodiscard]] constexpr auto unpack() const -> State<dim> {
+		return {units_player(), units_opponent(), board_base5()};
+	}
+
+	/// The state after the unit of the player moved and built, seen from the opponent (as 'Rules' applies actions): an
+	/// addition to the board word and a few shifts of the unit word, without decoding either.
+	[[nodiscard]] constexpr auto after_move(size_t unit_nr, std::uint64_t move_index, std::uint64_t build_index) const
+		-> PackedState {
+		constexpr std::uint64_t unit_mask = (std::uint64_t{1} << unit_bits) - 1;
+		constexpr std::uint64_t side_bits = dim.player_unit_count * unit_bits;
+		constexpr std::uint64_t side_mask = (std::uint64_t{1} << side_bits) - 1;
+		std::uint64_t const shift = unit_nr * unit_bits;
+		std::uint64_t const units = (words_[1] & ~(unit_mask << shift)) | (move_index << shift);
+		PackedState result;
+		result.words_[0] = words_[0] + Board<dim>::powers_of_5[build_index];
+		result.words_[1] = (units >> side_bits) | ((units & side_mask) << side_bits);
+		return result;
+	}
+
+	[[nodiscard]] auto hash() const -> size_t {
+		size_t hash = std::hash<std::uint64_t>{}(words_[0]);
+		tools::hash_combine(hash, words_[1]);
+		return hash;
+	}
+
+	friend auto operator<=>(const PackedState&, const PackedState&) = default;
+
+ private:
+	std::array<std::uint64_t, 2> words_{};
+
+	[[nodiscard]] static constexpr auto index_of(Position position) -> std::uint64_t {
+		return position.col + dim.cols * position.row;
+	}
+
+	[[nodiscard]] constexpr auto units_at(size_t first_unit) const -> Units {
+		constexpr std::uint64_t mask = (std::uint64_t{1} << unit_bits) - 1;
+		Units result{};
+		for (size_t unit_nr = 0; unit_nr < dim.player_unit_count; ++unit_nr) {
+			std::uint64_t const index = (words_[1] >> ((first_unit + unit_nr) * unit_bits)) & mask;
+			result[unit_nr] = {.row = static_cast<unsigned char>(index / dim.cols),
+				.col = static_cast<unsigned char>(index % dim.cols)};
+		}
+		return result;
+	}
+};
+
+/// An action packed into 16 bits: the move position in bits 0-4, the build position in bits 5-9 and the unit number in
+/// bits 10-15. Position indices depend on the number of columns, hence on the dimensions of the board.
+template <Dimensions dim>
+class PackedAction {
+ public:
+	static constexpr unsigned position_bits = 5;
+	static_assert(dim.position_count() <= 32, "positions are limited to 5 bits");  // NOLINT(*magic-numbers)
+
+	constexpr PackedAction() = default;
+
+	[[nodiscard]] static constexpr auto pack(Action action) -> PackedAction {
+		assert(action.unit_nr < 64);  // NOLINT(*magic-numbers): 6 bits
+		PackedAction result;
+		result.bits_ = static_cast<std::uint16_t>(index_of(action.move_location) |
+																							(index_of(action.build_location) << position_bits) |
+																							(unsigned{action.unit_nr} << (2 * position_bits)));
+		return result;
+	}
+
+	[[nodiscard]] constexpr auto unpack() const -> Action {
+		return {.unit_nr = static_cast<unsigned char>(bits_ >> (2 * position_bits)),
+			.move_location = position_of(bits_),
+			.build_location = position_of(static_cast<unsigned>(bits_ >> position_bits))};
+	}
+
+	[[nodiscard]] constexpr auto bits() const -> std::uint16_t { return bits_; }
+	[[nodiscard]] constexpr auto unit_nr() const -> size_t { return static_cast<size_t>(bits_ >> (2 * position_bits)); }
+	[[nodiscard]] constexpr auto move_index() const -> std::uint64_t { return bits_ & position_mask; }
+	[[nodiscard]] constexpr auto build_index() const -> std::uint64_t { return (bits_ >> position_bits) & position_mask; }
+
+	friend auto operator<=>(const PackedAction&, const PackedAction&) = default;
+
+ private:
+	static constexpr unsigned position_mask = (1U << position_bits) - 1;
+
+	std::uint16_t bits_ = 0;
+
+	[[nodiscard]] static constexpr auto index_of(Position position) -> unsigned {
+		return static_cast<unsigned>(position.col + dim.cols * position.row);
+	}
+
+	[[nodiscard]] static constexpr auto position_of(unsigned bits) -> Position {
+		unsigned const index = bits & position_mask;
+		return {.row = static_cast<unsigned char>(index / dim.cols), .col = static_cast<unsigned char>(index % dim.cols)};
+	}
+};
+
+/// 'Rules' on packed states and actions. The actions are generated by 'Rules::visit_actions' on the unpacked units and
+/// the encoded board, the successors are computed on the packed words. Neither needs a 'State' nor its Zobrist key.
+template <Dimensions dim>
+class PackedRules {
+ public:
+	static constexpr bool is_deterministic = true;
+
+	/// concept RulesEngine:
+	[[nodiscard]] auto list_roots() const -> std::vector<PackedState<dim>> {
+		std::vector<PackedState<dim>> result;
+		for (State<dim> const& root : rules_.list_roots())
+			result.push_back(PackedState<dim>::pack(root));
+		return result;
+	}
+
+	[[nodiscard]] auto list_actions(PackedState<dim> state) const -> std::vector<PackedAction<dim>> {
+		std::vector<PackedAction<dim>> result;
+		visit_actions(state, [&result](Action const& action) {
+			result.push_back(PackedAction<dim>::pack(action));
+			return true;
+		});
+		return result;
+	}
+
+	[[nodiscard]] auto list_edges(PackedState<dim> state, PackedAction<dim> action) const
+		-> std::vector<ActionEdge<PackedState<dim>>> {
+		return {ActionEdge<PackedState<dim>>(1.0F, successor_of(state, action))};
+	}
+
+	/// concept SuccessorListingRulesEngine: decodes the board once for all actions
+	[[nodiscard]] auto list_successors(PackedState<dim> state) const
+		-> ActionSuccessors<PackedState<dim>, PackedAction<dim>> {
+		ActionSuccessors<PackedState<dim>, PackedAction<dim>> result;
+		visit_actions(state, [&result, &state](Action const& action) {
+			PackedAction<dim> const packed = PackedAction<dim>::pack(action);
+			ActionEdge<PackedState<dim>> const edge(1.0F, successor_of(state, packed));
+			result.emplace_back(packed, std::vector<ActionEdge<PackedState<dim>>>{edge});
+			return true;
+		});
+		return result;
+	}
+
+	[[nodiscard]] auto score(PackedState<dim> state) const -> tools::Score {
+		return tools::Score{is_terminal(state) ? -1.0F : 0.0F};
+	}
+
+	/// concept CountingRulesEngine: stops at the first action, respectively counts without listing
+	[[nodiscard]] auto is_terminal(PackedState<dim> state) const -> bool {
+		return visit_actions(state, [](Action const& /*unused*/) { return false; });
+	}
+	[[nodiscard]] auto action_count(PackedState<dim> state) const -> size_t {
+		size_t result = 0;
+		visit_actions(state, [&result](Action const& /*unused*/) {
+			++result;
+			return true;
+		});
+		return result;
+	}
+
+	/// concept VertexPrinter:
+	[[nodiscard]] auto to_string(PackedState<dim> state) const -> std::string { return rules_.to_string(state.unpack()); }
+
+	[[nodiscard]] auto to_string(PackedState<dim> state, PackedAction<dim> action) const -> std::string {
+		return rules_.to_string(state.unpack(), action.unpack());
+	}
+
+ private:
+	Rules<dim> rules_;
+
+	template <std::predicate<Action const&> Visitor>
+	auto visit_actions(PackedState<dim> state, Visitor&& visitor) const -> bool {
+		return rules_.visit_actions(
+			state.units_player(), state.units_opponent(), state.board_base5(), std::forward<Visitor>(visitor));
+	}
+
+	[[nodiscard]] static auto successor_of(PackedState<dim> state, PackedAction<dim> action) -> PackedState<dim> {
+		return state.after_move(action.unit_nr(), action.move_index(), action.build_index());
+	}
+};
+
+template <Dimensions dim>
+struct PackedContainer : public DefaultGraphContainer_v1<PackedState<dim>, PackedAction<dim>> {
+	PackedContainer() : DefaultGraphContainer_v1<PackedState<dim>, PackedAction<dim>>(PackedRules<dim>()) {}
+};
+
+template <Dimensions dim>
+struct PackedGraph {
+	using state = PackedState<dim>;
+	using action = PackedAction<dim>;
+	using container = PackedContainer<dim>;
+	using rules = PackedRules<dim>;
+	using printer = PackedRules<dim>;
+};
+
+}  // namespace sag::santorini
+
+namespace std {
+
+template <sag::santorini::Dimensions dim>
+// NOLINTNEXTLINE(cert-dcl58-cpp)
+struct hash<sag::santorini::PackedState<dim>> {
+	auto operator()(sag::santorini::PackedState<dim> const& state) const noexcept -> std::size_t { return state.hash(); }
+};
+
+template <sag::santorini::Dimensions dim>
+// NOLINTNEXTLINE(cert-dcl58-cpp)
+struct hash<sag::santorini::PackedAction<dim>> {
+	auto operator()(sag::santorini::PackedAction<dim> const& action) const noexcept -> std::size_t {
+		return std::hash<std::uint16_t>{}(action.bits());
+	}
+};
+
+}  // namespace std
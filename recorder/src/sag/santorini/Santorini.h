@@ -5,6 +5,7 @@
 #include <array>
 #include <cassert>
 #include <map>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -45,14 +46,16 @@ class Board {
 	friend auto operator<=>(const Board&, const Board&) = default;
 
  public:
-	Board() {
+	constexpr Board() {
 		for (size_t i = 0; i < dim.position_count(); ++i)
 			data_[i] = BoardState::Empty;
 	}
 
-	explicit Board(std::array<BoardState, dim.position_count()> data) : data_(std::move(data)) {}
+	constexpr explicit Board(std::array<BoardState, dim.position_count()> data) : data_(std::move(data)) {}
 
-	[[nodiscard]] auto at(Position position) const -> BoardState { return data_[position.col + dim.cols * position.row]; }
+	[[nodiscard]] constexpr auto at(Position position) const -> BoardState {
+		return data_[position.col + dim.cols * position.row];
+	}
 
 	auto increment(Position position) -> void {
 		BoardState& current = data_[position.col + dim.cols * position.row];
@@ -62,24 +65,48 @@ class Board {
 
 	[[nodiscard]] auto underlying_array() const -> std::array<BoardState, dim.position_count()> const& { return data_; }
 
-	[[nodiscard]] auto static decode_base5(unsigned long long encoded_value) -> Board<dim> {
+	/// 5^k for each position k, exact (unlike pow(double, double) above 2^53)
+	static constexpr std::array<unsigned long long, dim.position_count()> powers_of_5 = [] {
+		static_assert(dim.position_count() <= 27, "base-5 encoding exceeds 64 bits");  // NOLINT(*magic-numbers)
+		std::array<unsigned long long, dim.position_count()> result{};
+		unsigned long long power = 1;
+		for (unsigned long long& entry : result) {
+			entry = power;
+			power *= static_cast<unsigned long long>(BoardState::VALUE_COUNT);
+		}
+		return result;
+	}();
+
+	[[nodiscard]] constexpr auto static decode_base5(unsigned long long encoded_value) -> Board<dim> {
+		// division by a constant compiles to a multiplication
+		constexpr auto base = static_cast<unsigned long long>(BoardState::VALUE_COUNT);
 		std::array<BoardState, dim.position_count()> board_data{};
-		for (size_t k = dim.position_count(); k > 0; --k) {
-			auto const factor =
-				static_cast<unsigned long long>(pow(static_cast<double>(BoardState::VALUE_COUNT), static_cast<double>(k - 1)));
-			auto const entry = static_cast<unsigned char>(encoded_value / factor);
-			board_data[k - 1] = static_cast<BoardState>(entry);
-			encoded_value -= entry * factor;
+		for (BoardState& entry : board_data) {
+			entry = static_cast<BoardState>(encoded_value % base);
+			encoded_value /= base;
 		}
 		return Board<dim>{board_data};
 	}
 
-	[[nodiscard]] auto encode_base5() const -> unsigned long long {
+	/// decodes each value into the board at the same index, 'boards' must be at least as long as 'encoded_values'
+	constexpr auto static decode_base5(std::span<unsigned long long const> encoded_values, std::span<Board<dim>> boards)
+		-> void {
+		assert(boards.size() >= encoded_values.size());
+		for (size_t index = 0; index < encoded_values.size(); ++index)
+			boards[index] = decode_base5(encoded_values[index]);
+	}
+
+	/// the entry of a single position, without decoding the whole board
+	[[nodiscard]] constexpr auto static decode_base5_at(unsigned long long encoded_value, Position position)
+		-> BoardState {
+		return static_cast<BoardState>(encoded_value / powers_of_5[position.col + dim.cols * position.row] %
+																	 static_cast<unsigned long long>(BoardState::VALUE_COUNT));
+	}
+
+	[[nodiscard]] constexpr auto encode_base5() const -> unsigned long long {
 		unsigned long long result = 0;
-		for (size_t k = 0; k < data_.size(); ++k) {
-			result += static_cast<unsigned long long>(data_[k]) *
-								static_cast<size_t>(pow(static_cast<double>(BoardState::VALUE_COUNT), static_cast<double>(k)));
-		}
+		for (size_t k = 0; k < data_.size(); ++k)
+			result += static_cast<unsigned long long>(data_[k]) * powers_of_5[k];
 		return result;
 	}
 };
@@ -0,0 +1,88 @@
+#include "MappedFile.h"
+
+#include <fmt/core.h>
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace tools {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(std::filesystem::path const& path) {
+	HANDLE const file = CreateFileW(
+		path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw std::runtime_error(fmt::format("could not open file '{}'", path.string()));
+
+	LARGE_INTEGER size{};
+	if (GetFileSizeEx(file, &size) == 0) {
+		CloseHandle(file);
+		throw std::runtime_error(fmt::format("could not read the size of file '{}'", path.string()));
+	}
+	if (size.QuadPart == 0) {
+		CloseHandle(file);
+		return;
+	}
+
+	// the view keeps the mapping (and the file) open, hence both handles may be closed right away
+	HANDLE const mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr)
+		throw std::runtime_error(fmt::format("could not map file '{}'", path.string()));
+	void const* const data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (data == nullptr)
+		throw std::runtime_error(fmt::format("could not map file '{}'", path.string()));
+
+	bytes_ = {static_cast<std::byte const*>(data), static_cast<size_t>(size.QuadPart)};
+}
+
+MappedFile::~MappedFile() {
+	if (!bytes_.empty())
+		UnmapViewOfFile(bytes_.data());
+}
+
+#else
+
+MappedFile::MappedFile(std::filesystem::path const& path) {
+	int const file = ::open(path.c_str(), O_RDONLY);  // NOLINT(cppcoreguidelines-pro-type-vararg)
+	if (file < 0)
+		throw std::runtime_error(fmt::format("could not open file '{}'", path.string()));
+
+	off_t const size = ::lseek(file, 0, SEEK_END);
+	if (size < 0) {
+		::close(file);
+		throw std::runtime_error(fmt::format("could not read the size of file '{}'", path.string()));
+	}
+	if (size == 0) {
+		::close(file);
+		return;
+	}
+
+	// the mapping stays valid after closing the descriptor
+	void* const data = ::mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_SHARED, file, 0);
+	::close(file);
+	if (data == MAP_FAILED)  // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+		throw std::runtime_error(fmt::format("could not map file '{}'", path.string()));
+
+	bytes_ = {static_cast<std::byte const*>(data), static_cast<size_t>(size)};
+}
+
+MappedFile::~MappedFile() {
+	if (!bytes_.empty())
+		::munmap(const_cast<std::byte*>(bytes_.data()), bytes_.size());
+}
+
+#endif
+
+}  // namespace tools
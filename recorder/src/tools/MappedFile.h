@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace tools {
+
+/// Read-only memory mapping of a whole file: ctor <-> mmap (MapViewOfFile) | dtor <-> munmap (UnmapViewOfFile).
+/// The pages are shared with all other mappings of the file, e.g. by other threads or processes.
+class MappedFile {
+ public:
+	/// throws std::runtime_error if the file cannot be opened or mapped
+	explicit MappedFile(std::filesystem::path const& path);
+	~MappedFile();
+
+	MappedFile(MappedFile const&) = delete;
+	MappedFile(MappedFile&&) = delete;
+	auto operator=(MappedFile const&) -> MappedFile& = delete;
+	auto operator=(MappedFile&&) -> MappedFile& = delete;
+
+	[[nodiscard]] auto bytes() const -> std::span<std::byte const> { return bytes_; }
+
+ private:
+	std::span<std::byte const> bytes_;
+};
+
+}  // namespace tools
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+namespace tools {
+
+/// Vector of at most 'Capacity' elements stored inline (no heap allocations), e.g. as a reusable buffer for move
+/// generation. Elements beyond the size stay default constructed.
+template <typename T, std::size_t Capacity>
+class StaticVector {
+ public:
+	using value_type = T;
+	using iterator = typename std::array<T, Capacity>::iterator;
+	using const_iterator = typename std::array<T, Capacity>::const_iterator;
+
+	static constexpr std::size_t capacity = Capacity;
+
+	constexpr StaticVector() = default;
+
+	constexpr auto push_back(T const& value) -> void {
+		assert(size_ < Capacity);
+		data_[size_++] = value;
+	}
+
+	template <typename... Args>
+	constexpr auto emplace_back(Args&&... args) -> T& {
+		assert(size_ < Capacity);
+		data_[size_] = T(std::forward<Args>(args)...);
+		return data_[size_++];
+	}
+
+	constexpr auto clear() -> void { size_ = 0; }
+
+	[[nodiscard]] constexpr auto size() const -> std::size_t { return size_; }
+	[[nodiscard]] constexpr auto empty() const -> bool { return size_ == 0; }
+
+	[[nodiscard]] constexpr auto operator[](std::size_t index) -> T& { return data_[index]; }
+	[[nodiscard]] constexpr auto operator[](std::size_t index) const -> T const& { return data_[index]; }
+
+	[[nodiscard]] constexpr auto begin() -> iterator { return data_.begin(); }
+	[[nodiscard]] constexpr auto end() -> iterator { return data_.begin() + static_cast<std::ptrdiff_t>(size_); }
+	[[nodiscard]] constexpr auto begin() const -> const_iterator { return data_.begin(); }
+	[[nodiscard]] constexpr auto end() const -> const_iterator {
+		return data_.begin() + static_cast<std::ptrdiff_t>(size_);
+	}
+
+	friend constexpr auto operator==(StaticVector const& lhs, StaticVector const& rhs) -> bool {
+		return lhs.size_ == rhs.size_ && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+ private:
+	std::array<T, Capacity> data_{};
+	std::size_t size_ = 0;
+};
+
+}  // namespace tools
@@ -2,6 +2,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <filesystem>
+#include <fstream>
 
 #include "../helpers.h"
 
@@ -22,6 +23,7 @@ TEST_CASE("ConfigReadWriteTest", "[app]") {
 
 	Recorder const recorder_config = {.db_file_path = "some_db_file",
 		.parallel_games = 5,
+		.graph_memory_budget_mb = 256,
 		.players = {{.name = "player-1", .mcts = mcts_1}, {.name = "player-2", .mcts = mcts_2}},
 		.log = {.console = SimpleLog{}, .file = file_log}};
 
@@ -33,3 +35,16 @@ TEST_CASE("ConfigReadWriteTest", "[app]") {
 	CHECK(read_config.has_value());
 	CHECK(read_config.value() == recorder_config);
 }
+
+TEST_CASE("ConfigWithoutGraphMemoryBudgetTest", "[app]") {
+	test::TempFilePath const file_path = test::unique_file_path(false);
+	{
+		std::ofstream file{file_path.get()};
+		file << R"({"db_file_path": "some_db_file", "parallel_games": 2, "players": [], "log": {}})";
+	}
+
+	const auto read_config = read<Recorder>(file_path.get());
+	REQUIRE(read_config.has_value());
+	CHECK(read_config->parallel_games == 2);
+	CHECK(read_config->graph_memory_budget_mb == 0);
+}
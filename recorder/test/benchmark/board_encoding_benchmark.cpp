@@ -0,0 +1,95 @@
+#include <fmt/core.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <random>
+
+#include "sag/santorini/Santorini.h"
+
+namespace {
+
+constexpr sag::santorini::Dimensions santorini_3x3_1 = {.rows = 3, .cols = 3, .player_unit_count = 1};
+constexpr sag::santorini::Dimensions santorini_5x5_2 = {.rows = 5, .cols = 5, .player_unit_count = 2};
+
+/// the former encoding, calling pow once per position (for reference)
+template <sag::santorini::Dimensions dim>
+auto encode_with_pow(sag::santorini::Board<dim> const& board) -> unsigned long long {
+	unsigned long long result = 0;
+	auto const& data = board.underlying_array();
+	for (size_t k = 0; k < data.size(); ++k)
+		result += static_cast<unsigned long long>(data[k]) * static_cast<size_t>(pow(5.0, static_cast<double>(k)));
+	return result;
+}
+
+/// the former decoding, calling pow once per position (for reference)
+template <sag::santorini::Dimensions dim>
+auto decode_with_pow(unsigned long long encoded_value) -> sag::santorini::Board<dim> {
+	std::array<sag::santorini::BoardState, dim.position_count()> board_data{};
+	for (size_t k = dim.position_count(); k > 0; --k) {
+		auto const factor = static_cast<unsigned long long>(pow(5.0, static_cast<double>(k - 1)));
+		auto const entry = static_cast<unsigned char>(encoded_value / factor);
+		board_data[k - 1] = static_cast<sag::santorini::BoardState>(entry);
+		encoded_value -= entry * factor;
+	}
+	return sag::santorini::Board<dim>{board_data};
+}
+
+template <sag::santorini::Dimensions dim>
+struct BoardDimensions {
+	using board = sag::santorini::Board<dim>;
+	static constexpr sag::santorini::Dimensions dimensions = dim;
+	static constexpr std::string_view name = dim.rows == 3 ? "3x3x1" : "5x5x2";
+};
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("Board encoding benchmark",
+	"[.][benchmark]",
+	BoardDimensions<santorini_3x3_1>,
+	BoardDimensions<santorini_5x5_2>) {
+	using Board = typename TestType::board;
+	constexpr size_t board_count = 10'000;
+	std::mt19937 rng(5);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible boards
+
+	std::vector<Board> boards;
+	std::vector<unsigned long long> encoded;
+	for (size_t i = 0; i < board_count; ++i) {
+		// low levels only, as in played games (and exact for the former encoding)
+		std::array<sag::santorini::BoardState, TestType::dimensions.position_count()> data{};
+		for (auto& entry : data)
+			entry = static_cast<sag::santorini::BoardState>(rng() % 3);
+		boards.emplace_back(data);
+		encoded.push_back(boards.back().encode_base5());
+	}
+
+	BENCHMARK(fmt::format("encode with pow, {}", TestType::name)) {
+		unsigned long long sum = 0;
+		for (Board const& board : boards)
+			sum += encode_with_pow(board);
+		return sum;
+	};
+	BENCHMARK(fmt::format("encode with table, {}", TestType::name)) {
+		unsigned long long sum = 0;
+		for (Board const& board : boards)
+			sum += board.encode_base5();
+		return sum;
+	};
+
+	std::vector<Board> decoded(board_count);
+	BENCHMARK(fmt::format("decode with pow, {}", TestType::name)) {
+		for (size_t i = 0; i < board_count; ++i)
+			decoded[i] = decode_with_pow<TestType::dimensions>(encoded[i]);
+		return decoded.back();
+	};
+	BENCHMARK(fmt::format("decode by constant division, {}", TestType::name)) {
+		for (size_t i = 0; i < board_count; ++i)
+			decoded[i] = Board::decode_base5(encoded[i]);
+		return decoded.back();
+	};
+	BENCHMARK(fmt::format("batch decode, {}", TestType::name)) {
+		Board::decode_base5(encoded, decoded);
+		return decoded.back();
+	};
+}
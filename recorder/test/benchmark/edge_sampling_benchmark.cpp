@@ -0,0 +1,69 @@
+#include <fmt/core.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <numeric>
+#include <random>
+
+#include "sag/DefaultGraphContainer_v2.h"
+#include "sag/ExampleGraph.h"
+#include "sag/GraphOperations.h"
+
+namespace {
+
+/// synthetic stochastic graph: a root with a few actions, each leading to 'fan_out' terminal states of random weight
+auto create_high_fan_out_rules(int fan_out) -> sag::example::Rules {
+	constexpr int action_count = 4;
+	std::mt19937 rng(42);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible weights
+	std::uniform_real_distribution<float> distribution(0.1F, 1.0F);
+
+	sag::example::GraphStructure graph_structure;
+	std::vector<sag::example::ActionEdges> root_actions;
+	int next_state = 1;
+	for (int action = 0; action < action_count; ++action) {
+		std::vector<float> weights(static_cast<size_t>(fan_out));
+		std::ranges::generate(weights, [&] { return distribution(rng); });
+		float const sum = std::accumulate(weights.begin(), weights.end(), 0.0F);
+
+		sag::example::ActionEdges edges;
+		for (float const weight : weights) {
+			edges.emplace_back(weight / sum, next_state);
+			graph_structure[next_state++] = {};
+		}
+		root_actions.push_back(std::move(edges));
+	}
+	graph_structure[0] = std::move(root_actions);
+	return sag::example::Rules(graph_structure);
+}
+
+}  // namespace
+
+TEST_CASE("Edge sampling benchmark", "[.][benchmark]") {
+	constexpr size_t roll_count = 10'000;
+	std::mt19937 rng(7);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible rolls
+	std::uniform_real_distribution<float> distribution(0.0F, 1.0F);
+	std::vector<tools::UnitValue> rolls(roll_count);
+	std::ranges::generate(rolls, [&] { return tools::UnitValue{distribution(rng)}; });
+
+	for (int const fan_out : {4, 64, 1024}) {
+		sag::example::Rules const rules = create_high_fan_out_rules(fan_out);
+		sag::DefaultGraphContainer_v2<int, int> graph{rules};
+		std::vector<int> const actions = graph.actions_at(0);
+		for (int const action : actions)
+			graph.expand_at(0, action, rules.list_edges(0, action), {});
+
+		BENCHMARK(fmt::format("linear scan, fan-out {}", fan_out)) {
+			long sum = 0;
+			for (size_t roll = 0; roll < roll_count; ++roll)
+				sum += sag::follow(graph.edges_view_at(0, actions[roll % actions.size()]), rolls[roll]);
+			return sum;
+		};
+
+		BENCHMARK(fmt::format("alias table, fan-out {}", fan_out)) {
+			long sum = 0;
+			for (size_t roll = 0; roll < roll_count; ++roll)
+				sum += graph.sample_at(0, actions[roll % actions.size()], rolls[roll]);
+			return sum;
+		};
+	}
+}
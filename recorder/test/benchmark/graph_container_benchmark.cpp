@@ -0,0 +1,178 @@
+#include <spdlog/spdlog.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+
+#include "../helpers.h"
+#include "../sag/graph_test.h"
+#include "sag/ArenaGraphContainer.h"
+#include "sag/DefaultGraphContainer_v2.h"
+#include "sag/DeterministicGraphContainer.h"
+#include "sag/EpochGraphContainer.h"
+#include "sag/InterningGraphContainer.h"
+#include "sag/LazyGraphContainer.h"
+#include "sag/TicTacToe.h"
+#include "sag/santorini/Graph.h"
+
+namespace {
+
+constexpr sag::santorini::Dimensions santorini_3x3_1 = {.rows = 3, .cols = 3, .player_unit_count = 1};
+
+template <typename G>
+concept BenchmarkGraph = TestGraphCollection<G> && requires {
+	{ G::name } -> std::convertible_to<std::string_view>;
+	{ G::state_limit } -> std::convertible_to<size_t>;
+};
+
+struct TicTacToe_v1 : Defaulted<sag::tic_tac_toe::Graph> {
+	static constexpr std::string_view name = "tic-tac-toe, v1";
+	static constexpr size_t state_limit = 10'000;
+};
+
+struct TicTacToe_v2 : Defaulted<WithContainer<sag::tic_tac_toe::Graph, sag::DefaultGraphContainer_v2>> {
+	static constexpr std::string_view name = "tic-tac-toe, v2";
+	static constexpr size_t state_limit = 10'000;
+};
+
+struct TicTacToe_arena : Defaulted<WithContainer<sag::tic_tac_toe::Graph, sag::ArenaGraphContainer>> {
+	static constexpr std::string_view name = "tic-tac-toe, arena";
+	static constexpr size_t state_limit = 10'000;
+};
+
+struct TicTacToe_interned : Defaulted<WithContainer<sag::tic_tac_toe::Graph, sag::InterningGraphContainer>> {
+	static constexpr std::string_view name = "tic-tac-toe, interned";
+	static constexpr size_t state_limit = 10'000;
+};
+
+struct TicTacToe_lazy : Defaulted<WithContainer<sag::tic_tac_toe::Graph, sag::LazyGraphContainer>> {
+	static constexpr std::string_view name = "tic-tac-toe, lazy";
+	static constexpr size_t state_limit = 10'000;
+};
+
+struct TicTacToe_deterministic
+		: Defaulted<WithContainer<sag::tic_tac_toe::Graph, sag::DeterministicGraphContainer>> {
+	static constexpr std::string_view name = "tic-tac-toe, deterministic";
+	static constexpr size_t state_limit = 10'000;
+};
+
+struct TicTacToe_epoch : Defaulted<WithContainer<sag::tic_tac_toe::Graph, sag::EpochGraphContainer>> {
+	static constexpr std::string_view name = "tic-tac-toe, epoch";
+	static constexpr size_t state_limit = 10'000;
+};
+
+struct Santorini_v1 : Defaulted<sag::santorini::Graph<santorini_3x3_1>> {
+	static constexpr std::string_view name = "santorini 3x3x1, v1";
+	static constexpr size_t state_limit = 50'000;
+};
+
+struct Santorini_v2
+		: Defaulted<WithContainer<sag::santorini::Graph<santorini_3x3_1>, sag::DefaultGraphContainer_v2>> {
+	static constexpr std::string_view name = "santorini 3x3x1, v2";
+	static constexpr size_t state_limit = 50'000;
+};
+
+struct Santorini_arena
+		: Defaulted<WithContainer<sag::santorini::Graph<santorini_3x3_1>, sag::ArenaGraphContainer>> {
+	static constexpr std::string_view name = "santorini 3x3x1, arena";
+	static constexpr size_t state_limit = 50'000;
+};
+
+struct Santorini_interned
+		: Defaulted<WithContainer<sag::santorini::Graph<santorini_3x3_1>, sag::InterningGraphContainer>> {
+	static constexpr std::string_view name = "santorini 3x3x1, interned";
+	static constexpr size_t state_limit = 50'000;
+};
+
+struct Santorini_lazy : Defaulted<WithContainer<sag::santorini::Graph<santorini_3x3_1>, sag::LazyGraphContainer>> {
+	static constexpr std::string_view name = "santorini 3x3x1, lazy";
+	static constexpr size_t state_limit = 50'000;
+};
+
+struct Santorini_deterministic
+		: Defaulted<WithContainer<sag::santorini::Graph<santorini_3x3_1>, sag::DeterministicGraphContainer>> {
+	static constexpr std::string_view name = "santorini 3x3x1, deterministic";
+	static constexpr size_t state_limit = 50'000;
+};
+
+struct Santorini_epoch
+		: Defaulted<WithContainer<sag::santorini::Graph<santorini_3x3_1>, sag::EpochGraphContainer>> {
+	static constexpr std::string_view name = "santorini 3x3x1, epoch";
+	static constexpr size_t state_limit = 50'000;
+};
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("Graph container benchmark",
+	"[.][benchmark]",
+	TicTacToe_v1,
+	TicTacToe_v2,
+	TicTacToe_arena,
+	TicTacToe_interned,
+	TicTacToe_lazy,
+	TicTacToe_deterministic,
+	TicTacToe_epoch,
+	Santorini_v1,
+	Santorini_v2,
+	Santorini_arena,
+	Santorini_interned,
+	Santorini_lazy,
+	Santorini_deterministic,
+	Santorini_epoch) {
+	static_assert(BenchmarkGraph<TestType>);
+	using S = typename TestType::state;
+	using A = typename TestType::action;
+
+	TestType const collection;
+	typename TestType::rules const rules = collection.get_rules();
+
+	// single measured fill: throughput and memory footprint
+	typename TestType::container graph = collection.get_container();
+	test::AllocationCounter const counter;
+	auto const start = std::chrono::steady_clock::now();
+	expand_breadth_first<S, A>(graph, rules, TestType::state_limit);
+	std::chrono::duration<double> const duration = std::chrono::steady_clock::now() - start;
+	auto const states = static_cast<double>(graph.state_count());
+	spdlog::default_logger()->info("{}: {} states, {:.0f} states/s (incl. rules), {:.1f} bytes/state",
+		TestType::name,
+		graph.state_count(),
+		states / duration.count(),
+		static_cast<double>(counter.net_bytes()) / states);
+
+	BENCHMARK("fill") {
+		typename TestType::container fresh = collection.get_container();
+		return expand_breadth_first<S, A>(fresh, rules, TestType::state_limit);
+	};
+
+	BENCHMARK("fill and clear_and_reroot") {
+		// compared to 'fill', this adds the teardown cost of a turn
+		typename TestType::container fresh = collection.get_container();
+		expand_breadth_first<S, A>(fresh, rules, TestType::state_limit);
+		fresh.clear_and_reroot(fresh.roots());
+		return fresh.state_count();
+	};
+
+	typename TestType::container reused = collection.get_container();
+	expand_breadth_first<S, A>(reused, rules, TestType::state_limit);
+	BENCHMARK("clear_and_reroot and refill") {
+		// a turn of a long-lived container: memory of the former turn may be reused
+		reused.clear_and_reroot(reused.roots());
+		return expand_breadth_first<S, A>(reused, rules, TestType::state_limit);
+	};
+
+	BENCHMARK("lookup") {
+		// walk the filled graph, touching all actions and edges
+		size_t edge_count = 0;
+		std::vector<S> queue = graph.roots();
+		for (size_t head = 0; head < queue.size() && head < TestType::state_limit; ++head) {
+			for (A const action : graph.actions_at(queue[head])) {
+				for (auto const& edge : graph.edges_at(queue[head], action)) {
+					++edge_count;
+					queue.push_back(edge.state());
+				}
+			}
+		}
+		return edge_count;
+	};
+}
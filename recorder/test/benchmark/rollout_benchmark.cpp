@@ -0,0 +1,59 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+
+#include "sag/TicTacToe.h"
+#include "sag/mcts/MCTS.h"
+#include "sag/santorini/Bitboard.h"
+#include "sag/santorini/Graph.h"
+
+namespace {
+
+constexpr sag::santorini::Dimensions santorini_5x5_2 = {.rows = 5, .cols = 5, .player_unit_count = 2};
+constexpr size_t rollout_count = 1'000;
+
+/// sum of the scores of 'rollout_count' rollouts from the first root
+template <sag::Graph G, typename Rollout>
+auto rollouts(typename G::rules const& rules, std::function<tools::UnitValue(void)>& random_source, Rollout&& rollout)
+	-> float {
+	typename G::state const root = rules.list_roots().front();
+	float result = 0.0F;
+	for (size_t i = 0; i < rollout_count; ++i)
+		result += rollout(root, random_source).value();
+	return result;
+}
+
+}  // namespace
+
+/// divide 'rollout_count' by the mean to get rollouts per second
+TEMPLATE_TEST_CASE("Rollout benchmark",
+	"[.][benchmark]",
+	sag::tic_tac_toe::Graph,
+	sag::santorini::Graph<santorini_5x5_2>,
+	sag::santorini::bitboard::Graph<santorini_5x5_2>) {
+	typename TestType::rules const rules{};
+	std::mt19937 rng(11);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible rollouts
+	std::uniform_real_distribution<float> distribution(0.0F, 1.0F);
+	std::function<tools::UnitValue(void)> random_source = [&]() { return tools::UnitValue(distribution(rng)); };
+
+	BENCHMARK("1000 rollouts on a new graph") {
+		typename TestType::container graph{};
+		return rollouts<TestType>(rules, random_source, [&](auto state, auto& source) {
+			return sag::mcts::random_rollout<TestType>(state, graph, rules, source);
+		});
+	};
+
+	typename TestType::container warm_graph{};
+	BENCHMARK("1000 rollouts on a warm graph") {
+		return rollouts<TestType>(rules, random_source, [&](auto state, auto& source) {
+			return sag::mcts::random_rollout<TestType>(state, warm_graph, rules, source);
+		});
+	};
+
+	BENCHMARK("1000 rollouts on the rules") {
+		return rollouts<TestType>(rules, random_source, [&](auto state, auto& source) {
+			return sag::mcts::rules_rollout<TestType>(state, rules, source);
+		});
+	};
+}
@@ -0,0 +1,78 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+#include "sag/santorini/Bitboard.h"
+#include "sag/santorini/Graph.h"
+#include "sag/santorini/Packed.h"
+
+namespace {
+
+constexpr sag::santorini::Dimensions santorini_5x5_2 = {.rows = 5, .cols = 5, .player_unit_count = 2};
+
+/// number of paths of the given length starting at the state (terminal states end a path early)
+template <typename S, typename R>
+auto perft(R const& rules, S const& state, int depth) -> size_t {
+	if (depth == 0)
+		return 1;
+	size_t count = 0;
+	for (auto const& action : rules.list_actions(state)) {
+		for (auto const& edge : rules.list_edges(state, action))
+			count += perft(rules, edge.state(), depth - 1);
+	}
+	return count;
+}
+
+/// as 'perft', generating into buffers on the stack (no allocations)
+template <typename S, typename R>
+auto perft_buffered(R const& rules, S const& state, int depth) -> size_t {
+	if (depth == 0)
+		return 1;
+	typename R::action_buffer actions;
+	typename R::edge_buffer edges;
+	rules.list_actions_into(state, actions);
+	size_t count = 0;
+	for (auto const& action : actions) {
+		rules.list_edges_into(state, action, edges);
+		for (auto const& edge : edges)
+			count += perft_buffered(rules, edge.state(), depth - 1);
+	}
+	return count;
+}
+
+}  // namespace
+
+TEST_CASE("Santorini perft benchmark", "[.][benchmark]") {
+	using namespace sag::santorini;
+	constexpr int depth = 3;
+	Rules<santorini_5x5_2> const rules{};
+	bitboard::Rules<santorini_5x5_2> const bitboard_rules{};
+	State<santorini_5x5_2> const root = rules.list_roots().front();
+	bitboard::State<santorini_5x5_2> const bitboard_root = bitboard_rules.list_roots().front();
+	REQUIRE(bitboard::to_bitboard(root) == bitboard_root);
+	REQUIRE(perft(rules, root, 2) == perft(bitboard_rules, bitboard_root, 2));
+	REQUIRE(perft(rules, root, 2) == perft_buffered(rules, root, 2));
+	PackedRules<santorini_5x5_2> const packed_rules{};
+	PackedState<santorini_5x5_2> const packed_root = PackedState<santorini_5x5_2>::pack(root);
+	REQUIRE(perft(rules, root, 2) == perft(packed_rules, packed_root, 2));
+
+	BENCHMARK("base-5 rules, 5x5x2, depth 3") { return perft(rules, root, depth); };
+	BENCHMARK("bitboard rules, 5x5x2, depth 3") { return perft(bitboard_rules, bitboard_root, depth); };
+	BENCHMARK("base-5 rules, buffered, 5x5x2, depth 3") { return perft_buffered(rules, root, depth); };
+	BENCHMARK("bitboard rules, buffered, 5x5x2, depth 3") {
+		return perft_buffered(bitboard_rules, bitboard_root, depth);
+	};
+	BENCHMARK("packed rules, 5x5x2, depth 3") { return perft(packed_rules, packed_root, depth); };
+}
+
+TEST_CASE("Santorini state copy benchmark", "[.][benchmark]") {
+	using namespace sag::santorini;
+	constexpr size_t state_count = size_t{1} << 20;
+	Rules<santorini_5x5_2> const rules{};
+	std::vector<State<santorini_5x5_2>> const states(state_count, rules.list_roots().front());
+	std::vector<PackedState<santorini_5x5_2>> const packed_states(
+		state_count, PackedState<santorini_5x5_2>::pack(states.front()));
+
+	BENCHMARK("copy 2^20 states") { return std::vector<State<santorini_5x5_2>>(states); };
+	BENCHMARK("copy 2^20 packed states") { return std::vector<PackedState<santorini_5x5_2>>(packed_states); };
+}
@@ -0,0 +1,104 @@
+#include <fmt/format.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <unordered_set>
+
+#include "sag/santorini/Graph.h"
+#include "tools/Hashing.h"
+
+namespace {
+
+constexpr sag::santorini::Dimensions santorini_5x5_2 = {.rows = 5, .cols = 5, .player_unit_count = 2};
+using State = sag::santorini::State<santorini_5x5_2>;
+
+/// the hash of states before Zobrist keys: the board bitset and both unit arrays combined
+auto combined_hash(State const& state) -> size_t {
+	size_t hash = std::hash<std::bitset<santorini_5x5_2.encoded_board_bitcount()>>()(state.board_base5);
+	tools::hash_combine(hash, state.units_player);
+	tools::hash_combine(hash, state.units_opponent);
+	return hash;
+}
+
+struct CombinedHash {
+	auto operator()(State const& state) const -> size_t { return combined_hash(state); }
+};
+
+/// the distinct states of random games
+auto random_game_states(size_t game_count) -> std::vector<State> {
+	sag::santorini::Rules<santorini_5x5_2> const rules{};
+	std::mt19937 rng(7);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible games
+	std::vector<State> const roots = rules.list_roots();
+	std::unordered_set<State> states;
+	for (size_t game = 0; game < game_count; ++game) {
+		State state = roots[rng() % roots.size()];
+		for (auto actions = rules.list_actions(state); !actions.empty(); actions = rules.list_actions(state)) {
+			state = rules.list_edges(state, actions[rng() % actions.size()]).front().state();
+			states.insert(state);
+		}
+	}
+	return {states.begin(), states.end()};
+}
+
+/// number of states sharing their hash (modulo 'bucket_count', if not 0) with a previous state
+template <typename Hash>
+auto collision_count(std::vector<State> const& states, Hash hash, size_t bucket_count) -> size_t {
+	std::unordered_set<size_t> seen;
+	size_t result = 0;
+	for (State const& state : states) {
+		size_t const value = bucket_count == 0 ? hash(state) : hash(state) % bucket_count;
+		if (!seen.insert(value).second)
+			++result;
+	}
+	return result;
+}
+
+}  // namespace
+
+TEST_CASE("State hashing benchmark", "[.][benchmark]") {
+	std::vector<State> const states = random_game_states(2'000);
+	constexpr size_t bucket_count = 1 << 16;
+	auto const zobrist_hash = [](State const& state) -> size_t { return state.hash(); };
+
+	SECTION("collisions") {
+		for (size_t const buckets : {size_t{0}, bucket_count}) {
+			WARN(fmt::format("{} states, {} buckets: combined hash collisions {}, Zobrist collisions {}",
+				states.size(),
+				buckets == 0 ? "2^64" : std::to_string(buckets),
+				collision_count(states, combined_hash, buckets),
+				collision_count(states, zobrist_hash, buckets)));
+		}
+		CHECK(collision_count(states, zobrist_hash, 0) == 0);
+	}
+
+	SECTION("speed") {
+		BENCHMARK(fmt::format("combined hash, {} states", states.size())) {
+			size_t result = 0;
+			for (State const& state : states)
+				result ^= combined_hash(state);
+			return result;
+		};
+		BENCHMARK(fmt::format("Zobrist key, {} states", states.size())) {
+			size_t result = 0;
+			for (State const& state : states)
+				result ^= state.hash();
+			return result;
+		};
+
+		std::unordered_set<State, CombinedHash> const combined_set(states.begin(), states.end());
+		std::unordered_set<State> const zobrist_set(states.begin(), states.end());
+		BENCHMARK("combined hash, set lookups") {
+			size_t found = 0;
+			for (State const& state : states)
+				found += combined_set.count(state);
+			return found;
+		};
+		BENCHMARK("Zobrist key, set lookups") {
+			size_t found = 0;
+			for (State const& state : states)
+				found += zobrist_set.count(state);
+			return found;
+		};
+	}
+}
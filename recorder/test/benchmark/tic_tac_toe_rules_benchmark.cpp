@@ -0,0 +1,40 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "sag/TicTacToe.h"
+
+namespace {
+
+using sag::tic_tac_toe::Graph;
+using sag::tic_tac_toe::Rules;
+
+/// number of complete games from the state, visiting every node of the game tree
+auto count_games(Graph::state state) -> size_t {
+	if (Rules::score(state).value() != 0.0F)
+		return 1;
+	std::vector<Graph::action> const actions = Rules::list_actions(state);
+	if (actions.empty())
+		return 1;  // draw
+	size_t count = 0;
+	for (Graph::action const action : actions)
+		count += count_games(Rules::list_edges(state, action).front().state());
+	return count;
+}
+
+}  // namespace
+
+TEST_CASE("TicTacToe rules benchmark", "[.][benchmark]") {
+	REQUIRE(count_games(0) == 255168);
+
+	BENCHMARK("complete game tree") { return count_games(0); };
+	BENCHMARK("complete game tree, list_successors") {
+		auto count = [](auto& self, Graph::state state) -> size_t {
+			auto const successors = Rules::list_successors(state);
+			size_t result = successors.empty() ? 1 : 0;
+			for (auto const& [action, edges] : successors)
+				result += self(self, edges.front().state());
+			return result;
+		};
+		return count(count, 0);
+	};
+}
@@ -1,9 +1,120 @@
 #include "helpers.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <new>
 #include <stdexcept>
 
+namespace {
+// per thread allocation statistics, updated by the replaced global operators new/delete below
+thread_local size_t allocation_count = 0;
+thread_local long long allocated_bytes = 0;
+
+// each allocation is prefixed by a header storing its size (right before the returned pointer). The header is as large
+// as the alignment, which keeps the alignment of the allocation.
+constexpr size_t default_alignment = alignof(std::max_align_t);
+
+constexpr auto header_size(size_t alignment) -> size_t {
+	return std::max(alignment, default_alignment);
+}
+
+auto counted_allocate(size_t size, size_t alignment = default_alignment) noexcept -> void* {
+	size_t const header = header_size(alignment);
+	size_t const block_size = (size + header + alignment - 1) / alignment * alignment;
+	void* block = std::aligned_alloc(header, block_size);  // NOLINT(*-no-malloc,*-owning-memory)
+	if (block == nullptr)
+		return nullptr;
+	std::byte* pointer = static_cast<std::byte*>(block) + header;
+	*reinterpret_cast<size_t*>(pointer - sizeof(size_t)) = size;  // NOLINT(*-reinterpret-cast)
+	++allocation_count;
+	allocated_bytes += static_cast<long long>(size);
+	return pointer;
+}
+
+auto counted_free(void* pointer, size_t alignment = default_alignment) noexcept -> void {
+	if (pointer == nullptr)
+		return;
+	auto* bytes = static_cast<std::byte*>(pointer);
+	allocated_bytes -= static_cast<long long>(*reinterpret_cast<size_t*>(bytes - sizeof(size_t)));  // NOLINT
+	std::free(bytes - header_size(alignment));  // NOLINT(*-no-malloc,*-owning-memory)
+}
+
+auto counted_allocate_or_throw(size_t size, size_t alignment = default_alignment) -> void* {
+	void* pointer = counted_allocate(size, alignment);
+	if (pointer == nullptr)
+		throw std::bad_alloc();
+	return pointer;
+}
+}  // namespace
+
+// NOLINTBEGIN(*-new-delete-operators)
+auto operator new(size_t size) -> void* {
+	return counted_allocate_or_throw(size);
+}
+auto operator new[](size_t size) -> void* {
+	return counted_allocate_or_throw(size);
+}
+auto operator new(size_t size, std::nothrow_t const& /*unused*/) noexcept -> void* {
+	return counted_allocate(size);
+}
+auto operator new[](size_t size, std::nothrow_t const& /*unused*/) noexcept -> void* {
+	return counted_allocate(size);
+}
+void operator delete(void* pointer) noexcept {
+	counted_free(pointer);
+}
+void operator delete[](void* pointer) noexcept {
+	counted_free(pointer);
+}
+void operator delete(void* pointer, size_t /*unused*/) noexcept {
+	counted_free(pointer);
+}
+void operator delete[](void* pointer, size_t /*unused*/) noexcept {
+	counted_free(pointer);
+}
+void operator delete(void* pointer, std::nothrow_t const& /*unused*/) noexcept {
+	counted_free(pointer);
+}
+void operator delete[](void* pointer, std::nothrow_t const& /*unused*/) noexcept {
+	counted_free(pointer);
+}
+
+// over-aligned variants (used e.g. by std::pmr::new_delete_resource)
+auto operator new(size_t size, std::align_val_t alignment) -> void* {
+	return counted_allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+auto operator new[](size_t size, std::align_val_t alignment) -> void* {
+	return counted_allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+auto operator new(size_t size, std::align_val_t alignment, std::nothrow_t const& /*unused*/) noexcept -> void* {
+	return counted_allocate(size, static_cast<size_t>(alignment));
+}
+auto operator new[](size_t size, std::align_val_t alignment, std::nothrow_t const& /*unused*/) noexcept -> void* {
+	return counted_allocate(size, static_cast<size_t>(alignment));
+}
+void operator delete(void* pointer, std::align_val_t alignment) noexcept {
+	counted_free(pointer, static_cast<size_t>(alignment));
+}
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept {
+	counted_free(pointer, static_cast<size_t>(alignment));
+}
+void operator delete(void* pointer, size_t /*unused*/, std::align_val_t alignment) noexcept {
+	counted_free(pointer, static_cast<size_t>(alignment));
+}
+void operator delete[](void* pointer, size_t /*unused*/, std::align_val_t alignment) noexcept {
+	counted_free(pointer, static_cast<size_t>(alignment));
+}
+void operator delete(void* pointer, std::align_val_t alignment, std::nothrow_t const& /*unused*/) noexcept {
+	counted_free(pointer, static_cast<size_t>(alignment));
+}
+void operator delete[](void* pointer, std::align_val_t alignment, std::nothrow_t const& /*unused*/) noexcept {
+	counted_free(pointer, static_cast<size_t>(alignment));
+}
+// NOLINTEND(*-new-delete-operators)
+
 namespace test {
 
 auto unique_file_path(bool create_file) -> TempFilePath {
@@ -22,4 +133,14 @@ auto unique_file_path(bool create_file) -> TempFilePath {
 	return tempfile;
 }
 
+AllocationCounter::AllocationCounter() : start_allocations_(allocation_count), start_bytes_(allocated_bytes) {}
+
+auto AllocationCounter::allocations() const -> size_t {
+	return allocation_count - start_allocations_;
+}
+
+auto AllocationCounter::net_bytes() const -> long long {
+	return allocated_bytes - start_bytes_;
+}
+
 }  // namespace test
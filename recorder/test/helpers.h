@@ -39,4 +39,20 @@ using TempFilePath = tools::unique_resource<std::string, FileDeleter>;
 /// Throws if the randomly chosen path exists.
 auto unique_file_path(bool create_file) -> TempFilePath;
 
+/// Tracks the heap allocations (via global operator new) of the current thread during its lifetime.
+/// The test binary replaces the global operator new/delete to support this.
+class AllocationCounter {
+ public:
+	AllocationCounter();
+
+	/// number of allocations since construction
+	[[nodiscard]] auto allocations() const -> size_t;
+	/// net bytes allocated since construction (allocated minus freed)
+	[[nodiscard]] auto net_bytes() const -> long long;
+
+ private:
+	size_t start_allocations_;
+	long long start_bytes_;
+};
+
 }  // namespace test
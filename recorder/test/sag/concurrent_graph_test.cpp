@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+#include "graph_test.h"
+#include "sag/DefaultGraphContainer_v2.h"
+#include "sag/StripedGraphContainer.h"
+#include "sag/TicTacToe.h"
+
+using namespace sag::tic_tac_toe;
+
+namespace {
+
+using StripedContainer = WithContainer<Graph, sag::StripedGraphContainer>::container;
+
+static_assert(sag::ConcurrentGraphContainer<StripedContainer, Graph::state, Graph::action>);
+static_assert(sag::CountingGraphContainer<StripedContainer, Graph::state, Graph::action>);
+static_assert(!sag::ConcurrentGraphContainer<Container, Graph::state, Graph::action>);
+static_assert(!sag::ConcurrentGraphContainer<WithContainer<Graph, sag::DefaultGraphContainer_v2>::container,
+	Graph::state,
+	Graph::action>);
+
+/// visits (and tries to expand) all state-actions, in a random order. Returns the number of successful expansions.
+auto expand_all_shuffled(StripedContainer& graph, Rules const& rules, std::mt19937::result_type seed) -> size_t {
+	std::mt19937 rng{seed};
+	size_t expansions = 0;
+	std::unordered_set<Graph::state> visited;
+	std::vector<Graph::state> pending = graph.roots();
+	while (!pending.empty()) {
+		std::swap(pending.back(), pending[std::uniform_int_distribution<size_t>(0, pending.size() - 1)(rng)]);
+		Graph::state const state = pending.back();
+		pending.pop_back();
+		if (!visited.insert(state).second)
+			continue;
+		for (Graph::action const action : graph.actions_at(state)) {
+			if (sag::expand(graph, rules, state, action))
+				++expansions;
+			for (auto const& edge : graph.edges_at(state, action))
+				pending.push_back(edge.state());
+		}
+	}
+	return expansions;
+}
+
+TEST_CASE("Striped graph container test (concurrent expansion)", "[sag]") {
+	Rules const rules{};
+	Container reference{};
+	size_t const expected_expansions =
+		expand_breadth_first<Graph::state, Graph::action>(reference, rules, std::numeric_limits<size_t>::max());
+
+	StripedContainer graph{};
+	std::atomic<size_t> expansions = 0;
+	{
+		std::vector<std::jthread> threads;
+		for (std::mt19937::result_type seed = 0; seed < 4; ++seed) {
+			threads.emplace_back(
+				[&graph, &rules, &expansions, seed]() { expansions += expand_all_shuffled(graph, rules, seed); });
+		}
+	}
+
+	// every state-action is expanded exactly once, with the same result as in a single thread
+	CHECK(expansions == expected_expansions);
+	CHECK(graph.state_count() == reference.state_count());
+	CHECK(graph.edge_count() == reference.edge_count());
+	std::vector<Graph::state> states = graph.roots();
+	std::unordered_set<Graph::state> visited;
+	while (!states.empty()) {
+		Graph::state const state = states.back();
+		states.pop_back();
+		if (!visited.insert(state).second)
+			continue;
+		REQUIRE(graph.actions_at(state) == reference.actions_at(state));
+		for (Graph::action const action : graph.actions_at(state)) {
+			REQUIRE(graph.edges_at(state, action) == reference.edges_at(state, action));
+			for (auto const& edge : graph.edges_at(state, action))
+				states.push_back(edge.state());
+		}
+	}
+
+	StripedContainer const copy = graph;
+	CHECK(copy == graph);
+	graph.clear_and_reroot(graph.roots());
+	CHECK(copy != graph);
+	CHECK(graph.state_count() == 1);
+}
+
+}  // namespace
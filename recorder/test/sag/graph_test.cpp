@@ -1,14 +1,65 @@
 #include "graph_test.h"
 
+#include "../helpers.h"
+
 #include <catch2/catch_template_test_macros.hpp>
+#include <memory_resource>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <unordered_set>
 
+#include "sag/AliasTable.h"
+#include "sag/ArenaGraphContainer.h"
+#include "sag/BudgetedGraphContainer.h"
+#include "sag/CachingRules.h"
+#include "sag/CanonicalRules.h"
+#include "sag/DefaultGraphContainer_v2.h"
+#include "sag/DeterministicGraphContainer.h"
+#include "sag/EpochGraphContainer.h"
 #include "sag/ExampleGraph.h"
+#include "sag/FrozenGraphContainer.h"
+#include "sag/InterningGraphContainer.h"
+#include "sag/LazyGraphContainer.h"
+#include "sag/StripedGraphContainer.h"
 #include "sag/TicTacToe.h"
+#include "sag/match/RandomPlayer.h"
+#include "sag/santorini/Bitboard.h"
 #include "sag/santorini/Graph.h"
+#include "sag/santorini/Packed.h"
 
 constexpr sag::santorini::Dimensions santorini_2x2_1 = {.rows = 2, .cols = 2, .player_unit_count = 1};
 constexpr sag::santorini::Dimensions santorini_3x5_2 = {.rows = 3, .cols = 5, .player_unit_count = 2};
 
+template <sag::Graph G>
+using Flat = WithContainer<G, sag::DefaultGraphContainer_v2>;
+template <sag::Graph G>
+using Striped = WithContainer<G, sag::StripedGraphContainer>;
+template <sag::Graph G>
+using Budgeted = WithContainer<G, sag::BudgetedGraphContainer>;
+template <sag::Graph G>
+using Arena = WithContainer<G, sag::ArenaGraphContainer>;
+template <sag::Graph G>
+using Interned = WithContainer<G, sag::InterningGraphContainer>;
+template <sag::Graph G>
+using Deterministic = WithContainer<G, sag::DeterministicGraphContainer>;
+template <sag::Graph G>
+using Lazy = WithContainer<G, sag::LazyGraphContainer>;
+template <sag::Graph G>
+using Epoch = WithContainer<G, sag::EpochGraphContainer>;
+
+/// replaces the rules of a graph collection by their canonical states under the symmetry Sym
+template <sag::Graph G, typename Sym>
+struct Canonicalized : public G {
+	using rules = sag::CanonicalRules<typename G::rules, Sym>;
+	struct container : public sag::DefaultGraphContainer_v1<typename G::state, typename G::action> {
+		container() : sag::DefaultGraphContainer_v1<typename G::state, typename G::action>(rules{}) {}
+	};
+};
+using CanonicalTicTacToe = Canonicalized<sag::tic_tac_toe::Graph, sag::tic_tac_toe::Symmetry>;
+using CanonicalSantorini =
+	Canonicalized<sag::santorini::Graph<santorini_3x5_2>, sag::santorini::Symmetry<santorini_3x5_2>>;
+
 struct ExampleGraphCollection {
 	using state = int;
 	using action = int;
@@ -50,7 +101,28 @@ TEMPLATE_TEST_CASE("Graph test",
 	ExampleGraphCollection,
 	Defaulted<sag::tic_tac_toe::Graph>,
 	Defaulted<sag::santorini::Graph<santorini_2x2_1>>,
-	Defaulted<sag::santorini::Graph<santorini_3x5_2>>) {
+	Defaulted<sag::santorini::Graph<santorini_3x5_2>>,
+	Defaulted<Flat<sag::tic_tac_toe::Graph>>,
+	Defaulted<Flat<sag::santorini::Graph<santorini_2x2_1>>>,
+	Defaulted<Flat<sag::santorini::Graph<santorini_3x5_2>>>,
+	Defaulted<Striped<sag::tic_tac_toe::Graph>>,
+	Defaulted<Striped<sag::santorini::Graph<santorini_3x5_2>>>,
+	Defaulted<Budgeted<sag::tic_tac_toe::Graph>>,
+	Defaulted<Budgeted<sag::santorini::Graph<santorini_3x5_2>>>,
+	Defaulted<Arena<sag::tic_tac_toe::Graph>>,
+	Defaulted<Arena<sag::santorini::Graph<santorini_3x5_2>>>,
+	Defaulted<Interned<sag::tic_tac_toe::Graph>>,
+	Defaulted<Interned<sag::santorini::Graph<santorini_2x2_1>>>,
+	Defaulted<Interned<sag::santorini::Graph<santorini_3x5_2>>>,
+	Defaulted<Lazy<sag::tic_tac_toe::Graph>>,
+	Defaulted<Lazy<sag::santorini::Graph<santorini_3x5_2>>>,
+	Defaulted<Deterministic<sag::tic_tac_toe::Graph>>,
+	Defaulted<Deterministic<sag::santorini::Graph<santorini_3x5_2>>>,
+	Defaulted<Epoch<sag::tic_tac_toe::Graph>>,
+	Defaulted<Epoch<sag::santorini::Graph<santorini_3x5_2>>>,
+	Defaulted<CanonicalTicTacToe>,
+	Defaulted<CanonicalSantorini>,
+	Defaulted<sag::santorini::PackedGraph<santorini_3x5_2>>) {
 	static_assert(TestGraphCollection<TestType>);
 
 	TestType testType;
@@ -74,3 +146,878 @@ TEMPLATE_TEST_CASE("Graph test",
 	for (auto state : visited_states)
 		logger->info("\n{}, score: {}", printer.to_string(state), rules.score(state).value());
 }
+
+TEMPLATE_TEST_CASE("Graph container reference test",
+	"[sag]",
+	Flat<sag::tic_tac_toe::Graph>,
+	Striped<sag::tic_tac_toe::Graph>,
+	Budgeted<sag::tic_tac_toe::Graph>,
+	Arena<sag::tic_tac_toe::Graph>,
+	Interned<sag::tic_tac_toe::Graph>,
+	Deterministic<sag::tic_tac_toe::Graph>,
+	Lazy<sag::tic_tac_toe::Graph>,
+	Epoch<sag::tic_tac_toe::Graph>) {
+	using S = typename TestType::state;
+	using A = typename TestType::action;
+	using C = typename TestType::container;
+
+	typename TestType::rules const rules{};
+	sag::tic_tac_toe::Container reference{};
+	C graph{};
+	CHECK(graph == C{});
+
+	// the same expansions lead to the same content as in the default container
+	CHECK(expand_breadth_first<S, A>(graph, rules, 2'000) == expand_breadth_first<S, A>(reference, rules, 2'000));
+	REQUIRE(graph.state_count() == reference.state_count());
+	CHECK(graph.edge_count() == reference.edge_count());
+	std::vector<S> states = graph.roots();
+	std::unordered_set<S> known(states.begin(), states.end());
+	size_t action_count = 0;
+	for (size_t head = 0; head < states.size(); ++head) {
+		S const state = states[head];
+		REQUIRE(graph.actions_at(state) == reference.actions_at(state));
+		action_count += graph.action_count_at(state);
+		for (A const action : graph.actions_at(state)) {
+			REQUIRE(graph.edges_at(state, action) == reference.edges_at(state, action));
+			for (auto const& edge : graph.edges_view_at(state, action)) {
+				if (known.insert(edge.state()).second)
+					states.push_back(edge.state());
+			}
+		}
+	}
+	CHECK(graph.state_count() == states.size());
+	CHECK(graph.action_count() == action_count);
+
+	C const copy = graph;  // NOLINT(performance-unnecessary-copy-initialization)
+	CHECK(copy == graph);
+	CHECK(graph != C{});
+
+	// reroot keeps the actions of the new root, but drops all expansions
+	S const new_root = states.back();
+	graph.clear_and_reroot({new_root});
+	CHECK(graph.roots() == std::vector<S>{new_root});
+	CHECK(graph.state_count() == 1);
+	CHECK(graph.edge_count() == 0);
+	CHECK(graph.actions_at(new_root) == reference.actions_at(new_root));
+	for (A const action : graph.actions_at(new_root))
+		CHECK_FALSE(graph.is_expanded_at(new_root, action));
+}
+
+TEMPLATE_TEST_CASE("Graph retain and reroot test",
+	"[sag]",
+	Defaulted<sag::tic_tac_toe::Graph>,
+	Defaulted<sag::santorini::Graph<santorini_2x2_1>>,
+	Defaulted<Flat<sag::tic_tac_toe::Graph>>,
+	Defaulted<Flat<sag::santorini::Graph<santorini_2x2_1>>>,
+	Defaulted<Budgeted<sag::tic_tac_toe::Graph>>) {
+	using S = typename TestType::state;
+	using A = typename TestType::action;
+	static_assert(sag::RetainingGraphContainer<typename TestType::container, S, A>);
+
+	TestType const collection;
+	typename TestType::container graph = collection.get_container();
+	expand_breadth_first<S, A>(graph, collection.get_rules(), 500);
+
+	// collect the (expanded) subgraph below a child of the root
+	S const root = graph.roots().front();
+	S const new_root = graph.edges_at(root, graph.actions_at(root).front()).front().state();
+	std::vector<std::tuple<S, A, std::vector<sag::ActionEdge<S>>>> subgraph;
+	std::unordered_set<S> reachable = {new_root};
+	std::vector<S> pending = {new_root};
+	while (!pending.empty()) {
+		S const state = pending.back();
+		pending.pop_back();
+		for (A const action : graph.actions_at(state)) {
+			subgraph.emplace_back(state, action, graph.edges_at(state, action));
+			for (auto const& edge : graph.edges_at(state, action)) {
+				if (reachable.insert(edge.state()).second)
+					pending.push_back(edge.state());
+			}
+		}
+	}
+	REQUIRE(reachable.size() > 1);
+
+	size_t const state_count = graph.state_count();
+	sag::RerootResult const result = graph.retain_and_reroot({new_root});
+	CHECK(result.kept_states == reachable.size());
+	CHECK(result.kept_states + result.freed_states == state_count);
+	CHECK(graph.state_count() == reachable.size());
+	CHECK(graph.roots() == std::vector<S>{new_root});
+	CHECK_THROWS(graph.is_terminal_at(root));
+
+	// all expansions below the new root are retained
+	for (auto const& [state, action, edges] : subgraph)
+		CHECK(graph.edges_at(state, action) == edges);
+}
+
+TEST_CASE("Budgeted graph container test", "[sag]") {
+	using namespace sag::tic_tac_toe;
+	using S = Graph::state;
+	using A = Graph::action;
+	struct BudgetedContainer : public sag::BudgetedGraphContainer<S, A> {
+		explicit BudgetedContainer(size_t byte_budget = unlimited)
+				: sag::BudgetedGraphContainer<S, A>(Rules{}, byte_budget) {}
+	};
+	static_assert(sag::MemoryReportingGraphContainer<BudgetedContainer, S, A>);
+
+	constexpr size_t budget = 64 * 1024;
+	Rules const rules{};
+	BudgetedContainer graph{budget};
+	BudgetedContainer unlimited{};
+	CHECK(graph == unlimited);
+	CHECK(graph.memory_usage() > 0);
+
+	// random descents starting at the root, as a search does
+	std::mt19937 rng{42};  // NOLINT (cert-*)
+	std::uniform_real_distribution<float> unit_distribution(0.0, 1.0);
+	auto descend = [&](BudgetedContainer& container) {
+		std::vector<S> path = container.roots();
+		while (!container.is_terminal_at(path.back())) {
+			S const state = path.back();
+			for (A const action : container.actions_at(state))
+				sag::expand(container, rules, state, action);
+			auto const actions = container.actions_at(state);
+			A const action = actions[static_cast<size_t>(unit_distribution(rng) * static_cast<float>(actions.size())) %
+															 actions.size()];
+			path.push_back(sag::follow(container.edges_view_at(state, action), tools::UnitValue(unit_distribution(rng))));
+
+			// the current path is never evicted
+			for (size_t i = 0; i + 1 < path.size(); ++i)
+				REQUIRE_NOTHROW(container.action_count_at(path[i + 1]));
+		}
+	};
+	for (size_t i = 0; i < 200; ++i) {
+		descend(graph);
+		descend(unlimited);
+		CHECK(graph.memory_usage() <= budget);
+	}
+
+	// the budget was exceeded (and hence evictions happened), the peak overshoots by at most one expansion
+	CHECK(unlimited.memory_usage() > budget);
+	CHECK(unlimited.evicted_state_count() == 0);
+	CHECK(graph.evicted_state_count() > 0);
+	CHECK(graph.state_count() < unlimited.state_count());
+	CHECK(graph.peak_memory_usage() > budget);
+	CHECK(graph.peak_memory_usage() < budget + budget / 4);
+	CHECK(unlimited.peak_memory_usage() == unlimited.memory_usage());
+
+	// exactly the states reachable from the root remain
+	std::vector<S> pending = graph.roots();
+	std::set<S> reachable{pending.begin(), pending.end()};
+	while (!pending.empty()) {
+		S const state = pending.back();
+		pending.pop_back();
+		for (A const action : graph.actions_at(state)) {
+			for (auto const& edge : graph.edges_at(state, action)) {
+				if (reachable.insert(edge.state()).second)
+					pending.push_back(edge.state());
+			}
+		}
+	}
+	CHECK(reachable.size() == graph.state_count());
+}
+
+namespace {
+/// upstream memory resource counting the blocks it hands out and gets back
+class CountingResource : public std::pmr::memory_resource {
+ public:
+	[[nodiscard]] auto allocations() const -> size_t { return allocations_; }
+	[[nodiscard]] auto outstanding() const -> size_t { return allocations_ - deallocations_; }
+
+ private:
+	size_t allocations_ = 0;
+	size_t deallocations_ = 0;
+
+	auto do_allocate(size_t bytes, size_t alignment) -> void* override {
+		++allocations_;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+	auto do_deallocate(void* pointer, size_t bytes, size_t alignment) -> void override {
+		++deallocations_;
+		std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+	}
+	[[nodiscard]] auto do_is_equal(std::pmr::memory_resource const& other) const noexcept -> bool override {
+		return this == &other;
+	}
+};
+}  // namespace
+
+TEST_CASE("Arena graph container test", "[sag]") {
+	using namespace sag::tic_tac_toe;
+	using S = Graph::state;
+	using A = Graph::action;
+	struct ArenaContainer : public sag::ArenaGraphContainer<S, A> {
+		explicit ArenaContainer(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+				: sag::ArenaGraphContainer<S, A>(Rules{}, upstream) {}
+	};
+
+	Rules const rules{};
+	CountingResource upstream;
+	ArenaContainer graph{&upstream};
+
+	// the graph is drawn from a few arena blocks
+	expand_breadth_first<S, A>(graph, rules, 2'000);
+	CHECK(upstream.allocations() < 64);
+
+	{
+		// moves hand over the arena, the moved-from container is left empty and usable
+		ArenaContainer copy = graph;
+		CHECK(copy == graph);
+		ArenaContainer moved = std::move(copy);
+		CHECK(moved == graph);
+		CHECK(copy.state_count() == 0);  // NOLINT(bugprone-use-after-move, hicpp-invalid-access-moved)
+		CHECK(copy.roots().empty());
+		copy.clear_and_reroot(graph.roots());
+		CHECK(copy.roots() == graph.roots());
+		CHECK(copy.state_count() == graph.roots().size());
+		copy = std::move(moved);
+		CHECK(copy == graph);
+		CHECK(moved.state_count() == 0);  // NOLINT(bugprone-use-after-move, hicpp-invalid-access-moved)
+	}
+
+	// reroot releases all blocks at once, and keeps the actions of the new root
+	S const root = graph.roots().front();
+	S const new_root = graph.edges_at(root, graph.actions_at(root).front()).front().state();
+	std::vector<A> const new_root_actions = graph.actions_at(new_root);
+	graph.clear_and_reroot({new_root});
+	CHECK(upstream.outstanding() <= 1);
+	CHECK(graph.actions_at(new_root) == new_root_actions);
+}
+
+TEST_CASE("Interning graph container test", "[sag]") {
+	using namespace sag::tic_tac_toe;
+	using S = Graph::state;
+	using A = Graph::action;
+	using InternedContainer = Interned<Graph>::container;
+	static_assert(sag::NodeIndexedGraphContainer<InternedContainer, S, A>);
+
+	Rules const rules{};
+	InternedContainer graph{};
+	expand_breadth_first<S, A>(graph, rules, 2'000);
+
+	// the nodes are dense and translate back to the same graph
+	REQUIRE(graph.node_count() == graph.state_count());
+	for (sag::NodeId node = 0; node < graph.node_count(); ++node) {
+		S const state = graph.state_of(node);
+		REQUIRE(graph.node_of(state) == node);
+		auto const actions = graph.node_actions(node);
+		REQUIRE(std::ranges::equal(actions, graph.actions_at(state)));
+		for (size_t index = 0; index < actions.size(); ++index) {
+			std::vector<sag::ActionEdge<S>> edges;
+			for (auto const& edge : graph.node_edges(node, index))
+				edges.emplace_back(edge.weight().value(), graph.state_of(edge.state()));
+			CHECK(graph.edges_at(state, actions[index]) == edges);
+		}
+	}
+	CHECK_THROWS_AS(graph.node_of(rules.encode({1, 1, 1, 1, 1, 1, 1, 1, 1})), std::out_of_range);
+
+	// reroot restarts the node ids
+	S const new_root = graph.state_of(static_cast<sag::NodeId>(graph.node_count() - 1));
+	graph.clear_and_reroot({new_root});
+	CHECK(graph.node_count() == 1);
+	CHECK(graph.node_of(new_root) == 0);
+}
+
+TEST_CASE("Lazy graph container test", "[sag]") {
+	using namespace sag::tic_tac_toe;
+	using S = Graph::state;
+	using A = Graph::action;
+
+	/// counts the listings of actions (shared by all copies)
+	struct CountingRules : public Rules {
+		std::shared_ptr<size_t> listings = std::make_shared<size_t>(0);
+		[[nodiscard]] auto list_actions(S state) const -> std::vector<A> {
+			++*listings;
+			return Rules::list_actions(state);
+		}
+	};
+	struct LazyContainer : public sag::LazyGraphContainer<S, A> {
+		LazyContainer() : LazyContainer(CountingRules{}) {}
+		explicit LazyContainer(CountingRules const& rules) : sag::LazyGraphContainer<S, A>(rules) {}
+	};
+	static_assert(sag::LazilyInitializingGraphContainer<LazyContainer, S, A>);
+
+	CountingRules const rules{};
+	LazyContainer graph{rules};
+	CHECK(*rules.listings == 0);
+
+	// expanding registers the successors only
+	S const root = graph.roots().front();
+	for (A const action : graph.actions_at(root))
+		REQUIRE(sag::expand(graph, rules, root, action));
+	CHECK(*rules.listings == 1);
+	CHECK(graph.state_count() == 10);
+	CHECK(graph.uninitialized_state_count() == 9);
+	CHECK(graph.action_count() == 9);
+
+	// the first access lists the actions, once
+	S const child = graph.edges_at(root, graph.actions_at(root).front()).front().state();
+	CHECK_FALSE(graph.is_terminal_at(child));
+	std::vector<A> const child_actions = graph.actions_at(child);
+	CHECK(child_actions.size() == 8);
+	CHECK(graph.action_count_at(child) == 8);
+	CHECK(*rules.listings == 2);
+	CHECK(graph.uninitialized_state_count() == 8);
+	CHECK(graph.action_count() == 17);
+
+	// a breadth first expansion lists the actions of the visited states only
+	CountingRules const full_rules{};
+	LazyContainer full{full_rules};
+	expand_breadth_first<S, A>(full, full_rules, 2'000);
+	CHECK(full.uninitialized_state_count() > 0);
+	CHECK(*full_rules.listings == full.state_count() - full.uninitialized_state_count());
+
+	// reroot keeps the listed actions of the new root, unknown roots are listed on access
+	graph.clear_and_reroot({child});
+	CHECK(graph.uninitialized_state_count() == 0);
+	CHECK(graph.actions_at(child) == child_actions);
+	S const unknown = rules.encode({1, 2, 1, 2, 0, 0, 0, 0, 0});
+	graph.clear_and_reroot({unknown});
+	CHECK(graph.uninitialized_state_count() == 1);
+	CHECK(graph.action_count_at(unknown) == 5);
+}
+
+TEST_CASE("Deterministic graph container test", "[sag]") {
+	using namespace sag::tic_tac_toe;
+	using S = Graph::state;
+	using A = Graph::action;
+	using DeterministicContainer = Deterministic<Graph>::container;
+	static_assert(sag::SingleChildGraphContainer<DeterministicContainer, S, A>);
+	static_assert(sag::DeterministicGraph<Deterministic<Graph>>);
+	static_assert(!sag::DeterministicGraph<ExampleGraphCollection>);
+
+	Rules const rules{};
+	DeterministicContainer graph{};
+	Container reference{};
+	S const root = graph.roots().front();
+	for (A const action : graph.actions_at(root)) {
+		sag::expand(graph, rules, root, action);
+		sag::expand(reference, rules, root, action);
+	}
+
+	// the single child equals the single edge of the rules, and the edge views are created from it
+	for (A const action : graph.actions_at(root)) {
+		auto const edges = rules.list_edges(root, action);
+		REQUIRE(edges.size() == 1);
+		CHECK(graph.child_at(root, action) == edges.front().state());
+		CHECK(sag::follow_single(graph, root, action) == edges.front().state());
+		CHECK(sag::follow_single(reference, root, action) == edges.front().state());
+		CHECK(graph.edges_at(root, action) == edges);
+		CHECK(graph.edge_count_at(root, action) == 1);
+	}
+
+	// only single edges are accepted
+	DeterministicContainer fresh{};
+	A const action = fresh.actions_at(root).front();
+	CHECK_FALSE(fresh.is_expanded_at(root, action));
+	CHECK(fresh.edges_view_at(root, action).empty());
+	std::vector<sag::ActionEdge<S>> const two_edges = {{0.5F, 1}, {0.5F, 2}};
+	CHECK_THROWS_AS(fresh.expand_at(root, action, two_edges, {}), std::invalid_argument);
+	CHECK_FALSE(fresh.is_expanded_at(root, action));
+	CHECK(fresh.edge_count() == 0);
+}
+
+TEST_CASE("Alias table test", "[sag]") {
+	// a grid of rolls hits each outcome proportionally to its weight
+	auto frequencies_of = [](std::vector<sag::ActionEdge<int>> const& edges) {
+		auto const table = sag::build_alias_table<int>(edges);
+		REQUIRE(table.size() == edges.size());
+		constexpr size_t roll_count = 10'000;
+		std::vector<float> frequencies(edges.size(), 0.0F);
+		for (size_t roll = 0; roll < roll_count; ++roll) {
+			auto const random_roll = tools::UnitValue{(static_cast<float>(roll) + 0.5F) / roll_count};
+			frequencies[sag::sample_alias(table, random_roll)] += 1.0F / roll_count;
+		}
+		return frequencies;
+	};
+
+	auto const weighted = frequencies_of({{0.1F, 1}, {0.2F, 2}, {0.3F, 3}, {0.4F, 4}});
+	CHECK_THAT(weighted[0], Catch::Matchers::WithinAbs(0.1, 0.001));
+	CHECK_THAT(weighted[1], Catch::Matchers::WithinAbs(0.2, 0.001));
+	CHECK_THAT(weighted[2], Catch::Matchers::WithinAbs(0.3, 0.001));
+	CHECK_THAT(weighted[3], Catch::Matchers::WithinAbs(0.4, 0.001));
+
+	auto const skewed = frequencies_of({{0.01F, 1}, {0.98F, 2}, {0.01F, 3}});
+	CHECK_THAT(skewed[0], Catch::Matchers::WithinAbs(0.01, 0.001));
+	CHECK_THAT(skewed[1], Catch::Matchers::WithinAbs(0.98, 0.001));
+
+	CHECK_THAT(frequencies_of({{1.0F, 1}}).front(), Catch::Matchers::WithinAbs(1.0, 0.001));
+	CHECK(sag::sample_alias(sag::build_alias_table<int>(std::vector<sag::ActionEdge<int>>{{0.5F, 1}, {0.5F, 2}}),
+					tools::UnitValue{1.0F}) == 1);
+
+	// the flat container samples from its edges by their tables
+	ExampleGraphCollection const collection;
+	sag::example::Rules const rules = collection.get_rules();
+	sag::DefaultGraphContainer_v2<int, int> graph{rules};
+	CHECK_THROWS_AS(graph.sample_at(1, graph.actions_at(1).front(), tools::UnitValue{0.5F}), std::out_of_range);
+	std::set<int> sampled;
+	for (int const action : graph.actions_at(1)) {
+		REQUIRE(graph.expand_at(1, action, rules.list_edges(1, action), {}));
+		auto const edges = graph.edges_at(1, action);
+		for (float roll = 0.0F; roll <= 1.0F; roll += 0.125F) {
+			int const state = graph.sample_at(1, action, tools::UnitValue{roll});
+			CHECK(std::ranges::count(edges, state, &sag::ActionEdge<int>::state) == 1);
+			sampled.insert(state);
+		}
+	}
+	CHECK(sampled == std::set<int>{2, 3, 5, 6});
+}
+
+TEMPLATE_TEST_CASE("Batch expansion test",
+	"[sag]",
+	Defaulted<sag::tic_tac_toe::Graph>,
+	Defaulted<sag::santorini::Graph<santorini_3x5_2>>,
+	Defaulted<Flat<sag::tic_tac_toe::Graph>>,
+	Defaulted<Flat<sag::santorini::Graph<santorini_3x5_2>>>,
+	Defaulted<Lazy<sag::tic_tac_toe::Graph>>) {
+	using S = typename TestType::state;
+	using A = typename TestType::action;
+	TestType const collection;
+	typename TestType::rules const rules = collection.get_rules();
+
+	// the successors listed in one pass equal the listing per action
+	S const root = rules.list_roots().front();
+	auto const successors = sag::list_successors<S, A>(rules, root);
+	REQUIRE(successors.size() == rules.list_actions(root).size());
+	for (auto const& [action, edges] : successors)
+		CHECK(edges == rules.list_edges(root, action));
+
+	// expanding all actions at once equals expanding them one by one, also if some are expanded already
+	typename TestType::container batched = collection.get_container();
+	typename TestType::container single = collection.get_container();
+	std::vector<A> const actions = single.actions_at(root);
+	REQUIRE(sag::expand(batched, rules, root, actions.back()));
+	for (A const action : actions)
+		REQUIRE(sag::expand(single, rules, root, action));
+	CHECK(sag::expand_all<S, A>(batched, rules, root) == actions.size() - 1);
+	CHECK(batched == single);
+	CHECK(sag::expand_all<S, A>(batched, rules, root) == 0);
+
+	S const child = single.edges_at(root, actions.front()).front().state();
+	for (A const action : single.actions_at(child))
+		sag::expand(single, rules, child, action);
+	CHECK(sag::expand_all<S, A>(batched, rules, child) == batched.actions_at(child).size());
+	CHECK(batched == single);
+}
+
+TEST_CASE("Expansion allocation test", "[sag]") {
+	using namespace sag::tic_tac_toe;
+	using S = Graph::state;
+	using A = Graph::action;
+	Rules const rules{};
+
+	/// expands breadth first, returns the maximum allocations of 'expand_at' per successor state (excluding the rules)
+	auto max_allocations_per_child = [&rules](auto& graph) {
+		size_t result = 0;
+		std::vector<S> queue = graph.roots();
+		for (size_t head = 0; head < queue.size() && head < 1'000; ++head) {
+			S const state = queue[head];
+			for (A const action : graph.actions_at(state)) {
+				if (graph.is_expanded_at(state, action))
+					continue;  // reached via another parent
+				std::vector<sag::ActionEdge<S>> new_edges = rules.list_edges(state, action);
+				std::vector<std::pair<S, std::vector<A>>> next_states;
+				for (auto const& edge : new_edges) {
+					next_states.emplace_back(edge.state(), rules.list_actions(edge.state()));
+					queue.push_back(edge.state());
+				}
+				size_t const child_count = next_states.size();
+
+				test::AllocationCounter const counter;
+				REQUIRE(graph.expand_at(state, action, std::move(new_edges), std::move(next_states)));
+				result = std::max(result, counter.allocations() / child_count);
+			}
+		}
+		return result;
+	};
+
+	SECTION("node based container") {
+		// per successor: its hash map node and its edge vectors (the moved edges and actions are not copied).
+		// A growing bucket array may add one allocation, hence at most 3 for the single successor of tic-tac-toe.
+		Container graph{};
+		CHECK(max_allocations_per_child(graph) <= 3);
+	}
+
+	SECTION("flat container") {
+		// each pool grows at most once: states, state actions, actions, action edges, edges, alias tables and index
+		Flat<Graph>::container graph{};
+		CHECK(max_allocations_per_child(graph) <= 7);
+	}
+}
+
+TEMPLATE_TEST_CASE("Buffered move generation test",
+	"[sag]",
+	sag::tic_tac_toe::Graph,
+	sag::santorini::Graph<santorini_3x5_2>,
+	sag::santorini::bitboard::Graph<santorini_3x5_2>) {
+	using S = typename TestType::state;
+	using A = typename TestType::action;
+	using R = typename TestType::rules;
+	static_assert(sag::BufferedRulesEngine<R, S, A>);
+	R const rules{};
+	typename R::action_buffer actions;
+	typename R::edge_buffer edges;
+	sag::match::RandomPlayer<TestType> player{};
+	typename TestType::container graph{};
+
+	// random walks: the buffers hold the same as the vectors, filling them does not allocate
+	std::mt19937 rng(13);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible walks
+	std::vector<S> const roots = rules.list_roots();
+	rules.list_actions_into(roots.front(), actions);  // warm up caches of the rules
+	for (int walk = 0; walk < 20; ++walk) {
+		for (S state = roots[rng() % roots.size()]; !rules.list_actions(state).empty();) {
+			std::vector<A> const expected = rules.list_actions(state);
+			test::AllocationCounter const counter;
+			rules.list_actions_into(state, actions);
+			A const action = actions[rng() % actions.size()];
+			rules.list_edges_into(state, action, edges);
+			A const played = player.choose_play(state, graph, rules);
+			CHECK(counter.allocations() == 0);
+
+			CHECK(std::ranges::equal(actions, expected));
+			CHECK(std::ranges::find(expected, played) != expected.end());
+			CHECK(std::ranges::equal(edges, rules.list_edges(state, action)));
+			CHECK(sag::list_actions<S, A>(rules, state) == expected);
+			CHECK(sag::list_edges<S, A>(rules, state, action) == rules.list_edges(state, action));
+			state = edges[0].state();
+		}
+	}
+}
+
+TEMPLATE_TEST_CASE("Counting rules test",
+	"[sag]",
+	sag::tic_tac_toe::Graph,
+	sag::santorini::Graph<santorini_3x5_2>,
+	sag::santorini::bitboard::Graph<santorini_3x5_2>,
+	sag::santorini::PackedGraph<santorini_3x5_2>) {
+	using S = typename TestType::state;
+	using A = typename TestType::action;
+	using R = typename TestType::rules;
+	static_assert(sag::CountingRulesEngine<R, S, A>);
+	R const rules{};
+
+	// random walks until the end of the game: counting as listing, without allocations
+	std::mt19937 rng(17);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible walks
+	std::vector<S> const roots = rules.list_roots();
+	for (int walk = 0; walk < 20; ++walk) {
+		S state = roots[rng() % roots.size()];
+		while (true) {
+			std::vector<A> const actions = rules.list_actions(state);
+			test::AllocationCounter const counter;
+			bool const is_terminal = rules.is_terminal(state);
+			size_t const action_count = rules.action_count(state);
+			CHECK(counter.allocations() == 0);
+
+			CHECK(is_terminal == actions.empty());
+			CHECK(action_count == actions.size());
+			CHECK(sag::is_terminal<S, A>(rules, state) == is_terminal);
+			CHECK(sag::action_count<S, A>(rules, state) == action_count);
+			CHECK(rules.score(state).value() == (is_terminal ? -1.0F : 0.0F));
+			if (is_terminal)
+				break;
+			state = rules.list_edges(state, actions[rng() % actions.size()]).front().state();
+		}
+	}
+
+	// the fallbacks of rules engines without counting
+	sag::CachingRules<R> const cached{};
+	CHECK(sag::is_terminal<S, A>(cached, roots.front()) == rules.is_terminal(roots.front()));
+	CHECK(sag::action_count<S, A>(cached, roots.front()) == rules.action_count(roots.front()));
+}
+
+TEST_CASE("Epoch graph container test", "[sag]") {
+	using namespace sag::tic_tac_toe;
+	using S = Graph::state;
+	using EpochContainer = Epoch<Graph>::container;
+
+	Rules const rules{};
+	EpochContainer graph{};
+
+	/// expands breadth first, returns the visited states and the allocations of the container (excluding the rules)
+	auto fill = [&rules](auto& container) {
+		using A = Graph::action;
+		size_t allocations = 0;
+		std::vector<S> queue = container.roots();
+		for (size_t head = 0; head < queue.size() && head < 2'000; ++head) {
+			for (A const action : container.actions_at(queue[head])) {
+				if (container.is_expanded_at(queue[head], action))
+					continue;
+				std::vector<sag::ActionEdge<S>> new_edges = rules.list_edges(queue[head], action);
+				std::vector<std::pair<S, std::vector<A>>> next_states;
+				for (auto const& edge : new_edges) {
+					next_states.emplace_back(edge.state(), rules.list_actions(edge.state()));
+					queue.push_back(edge.state());
+				}
+				test::AllocationCounter const counter;
+				container.expand_at(queue[head], action, std::move(new_edges), std::move(next_states));
+				allocations += counter.allocations();
+			}
+		}
+		return std::pair{queue, allocations};
+	};
+	auto const [states, first_fill_allocations] = fill(graph);
+
+	// the next turn on the same roots reuses the stale slots in place, only the rules allocate
+	EpochContainer const copy = graph;
+	std::vector<S> const roots = graph.roots();
+	graph.clear_and_reroot(roots);
+	CHECK(fill(graph).second < first_fill_allocations / 10);
+	CHECK(graph == copy);
+
+	// reroot: a new epoch, the states of the former one are absent, but their memory is kept
+	S const new_root = states[states.size() / 2];
+	size_t const slot_count = graph.slot_count();
+	auto const epoch = graph.epoch();
+	{
+		std::vector<S> new_roots{new_root};
+		test::AllocationCounter const counter;
+		graph.clear_and_reroot(std::move(new_roots));
+		// the root data, and the vectors of its slot if too small
+		CHECK(counter.allocations() <= 4);
+	}
+	CHECK(graph.epoch() == epoch + 1);
+	CHECK(graph.slot_count() == slot_count);
+	CHECK(graph.actions_at(new_root) == copy.actions_at(new_root));
+	CHECK_THROWS_AS(graph.actions_at(states.back()), std::out_of_range);
+
+	// after a turn using only a small fraction of the slots, the table is compacted
+	S const terminal = *std::ranges::find_if(states, [&](S state) { return rules.list_actions(state).empty(); });
+	CHECK(graph.compaction_count() == 0);
+	graph.clear_and_reroot({terminal});
+	CHECK(graph.compaction_count() == 1);
+	CHECK(graph.slot_count() == EpochContainer::initial_slot_count);
+	CHECK(graph.roots() == std::vector<S>{terminal});
+	CHECK(graph.is_terminal_at(terminal));
+}
+
+TEST_CASE("Frozen graph container test", "[sag]") {
+	using namespace sag::tic_tac_toe;
+	using S = Graph::state;
+	using A = Graph::action;
+	using FrozenContainer = sag::FrozenGraphContainer<S, A>;
+	static_assert(sag::CountingGraphContainer<FrozenContainer, S, A>);
+	static_assert(sag::NodeIndexedGraphContainer<FrozenContainer, S, A>);
+
+	Rules const rules{};
+	test::TempFilePath const file = test::unique_file_path(false);
+	sag::FrozenGraphHeader const header = sag::freeze_graph<S, A>(rules, file.get());
+	FrozenContainer const graph{file.get()};
+
+	// the complete graph of tic-tac-toe, compared to a fully expanded default container
+	Container reference{};
+	std::vector<S> queue = reference.roots();
+	for (size_t head = 0; head < queue.size(); ++head) {
+		for (A const action : reference.actions_at(queue[head])) {
+			if (sag::expand(reference, rules, queue[head], action)) {
+				for (auto const& edge : reference.edges_view_at(queue[head], action))
+					queue.push_back(edge.state());
+			}
+		}
+	}
+	CHECK(header.state_count == 5478);
+	CHECK(graph.state_count() == reference.state_count());
+	CHECK(graph.edge_count() == reference.edge_count());
+	CHECK(graph.roots() == reference.roots());
+	for (S const state : queue) {
+		REQUIRE(graph.actions_at(state) == reference.actions_at(state));
+		CHECK(graph.is_terminal_at(state) == reference.is_terminal_at(state));
+		for (A const action : graph.actions_at(state)) {
+			CHECK(graph.is_expanded_at(state, action));
+			CHECK(graph.edges_at(state, action) == reference.edges_at(state, action));
+		}
+	}
+	for (sag::NodeId node = 0; node < graph.node_count(); ++node)
+		CHECK(graph.node_of(graph.state_of(node)) == node);
+
+	// read-only: expansions are no-ops, rerooting only replaces the roots
+	FrozenContainer copy = graph;
+	CHECK(copy == graph);
+	CHECK(copy.actions_view_at(0).data() == graph.actions_view_at(0).data());  // shared mapping
+	S const state = queue.back();
+	CHECK_FALSE(sag::expand(copy, rules, S{0}, A{1}));
+	CHECK_FALSE(copy.add(state, rules.list_actions(state)));
+	copy.clear_and_reroot({state});
+	CHECK(copy.roots() == std::vector<S>{state});
+	CHECK(copy.state_count() == graph.state_count());
+	CHECK(copy != graph);
+	CHECK(FrozenContainer{file.get()} == graph);
+
+	// states and actions unknown to the file
+	CHECK_THROWS_AS(copy.actions_at(S{1}), std::out_of_range);  // player 2 cannot move first
+	CHECK_THROWS_AS(copy.clear_and_reroot({S{1}}), std::out_of_range);
+	CHECK_THROWS_AS(copy.edges_at(0, A{10}), std::out_of_range);
+	CHECK(FrozenContainer{}.state_count() == 0);
+	CHECK_THROWS_AS(FrozenContainer{}.actions_at(0), std::out_of_range);
+
+	// files of other types or no frozen graph at all
+	CHECK_THROWS_AS((sag::FrozenGraphContainer<std::uint32_t, A>{file.get()}), std::runtime_error);
+	test::TempFilePath const empty_file = test::unique_file_path(true);
+	CHECK_THROWS_AS(FrozenContainer{empty_file.get()}, std::runtime_error);
+	CHECK_THROWS_AS(FrozenContainer{empty_file.get() + ".missing"}, std::runtime_error);
+}
+
+TEST_CASE("TicTacToe rules test", "[sag]") {
+	using namespace sag::tic_tac_toe;
+	// the table lookups against decoding the board
+	for (size_t state_id = 0; state_id < StateCount; ++state_id) {
+		auto const state = static_cast<Graph::state>(state_id);
+		Board const board = Rules::decode(state);
+		REQUIRE(Rules::encode(board) == state);
+		std::vector<Graph::action> const actions = Rules::list_actions(state);
+		CHECK(Rules::score(state).value() == (actions.empty() ? -1.0F : 0.0F));
+		for (Graph::action const action : actions) {
+			REQUIRE(board[static_cast<size_t>(action)] == 0);
+			Board expected{};  // seen from the next player
+			for (size_t i = 0; i < BoardSize; ++i)
+				expected[i] = static_cast<Graph::state>(board[i] == 0 ? 0 : 3 - board[i]);
+			expected[static_cast<size_t>(action)] = 2;
+			CHECK(Rules::decode(Rules::list_edges(state, action).front().state()) == expected);
+		}
+		CHECK(Rules::list_successors(state).size() == actions.size());
+	}
+
+	CHECK(Rules::list_actions(0) == std::vector<Graph::action>{0, 1, 2, 3, 4, 5, 6, 7, 8});
+	// the opponent owns the top row
+	constexpr Graph::state top_row = 2 + 2 * 3 + 2 * 9;
+	CHECK(Rules::list_actions(top_row).empty());
+	CHECK(Rules::score(top_row).value() == -1.0F);
+}
+
+TEST_CASE("Caching rules test", "[sag]") {
+	using namespace sag::santorini;
+	using S = State<santorini_3x5_2>;
+	using Cached = sag::CachingRules<Rules<santorini_3x5_2>>;
+	static_assert(sag::RulesEngine<Cached, S, Action>);
+	static_assert(sag::DeterministicRulesEngine<Cached, S, Action>);
+	static_assert(sag::SuccessorListingRulesEngine<Cached, S, Action>);
+	static_assert(sag::RulesEngine<sag::CachingRules<sag::tic_tac_toe::Rules>,
+		sag::tic_tac_toe::Graph::state,
+		sag::tic_tac_toe::Graph::action>);
+
+	Rules<santorini_3x5_2> const rules{};
+	Cached const cached{rules, Cached::shard_count};  // a single state per shard
+	CHECK(cached.capacity() == Cached::shard_count);
+	CHECK(cached.stats() == sag::CachingStats{});
+
+	// same results as the wrapped engine, computed once per state while it stays cached
+	S const root = rules.list_roots().front();
+	CHECK(cached.list_roots() == rules.list_roots());
+	std::vector<Action> const actions = rules.list_actions(root);
+	CHECK(cached.list_actions(root) == actions);
+	CHECK(cached.stats() == sag::CachingStats{.hits = 0, .misses = 1, .evictions = 0});
+	for (Action const& action : actions)
+		CHECK(cached.list_edges(root, action) == rules.list_edges(root, action));
+	CHECK(cached.score(root) == rules.score(root));
+	CHECK(cached.list_successors(root) == rules.list_successors(root));
+	CHECK(cached.stats() == sag::CachingStats{.hits = actions.size() + 2, .misses = 1, .evictions = 0});
+
+	// bounded: another state of the same shard evicts the least recently used
+	auto const shard_of = [](S const& state) { return std::hash<S>{}(state) % Cached::shard_count; };
+	auto const root_successors = rules.list_successors(root);
+	auto const same_shard = std::ranges::find_if(root_successors, [&](auto const& successors) {
+		return shard_of(successors.second.front().state()) == shard_of(root);
+	});
+	REQUIRE(same_shard != root_successors.end());
+	S const successor = same_shard->second.front().state();
+	CHECK(cached.list_successors(successor) == rules.list_successors(successor));
+	CHECK(cached.list_actions(root) == actions);
+	CHECK(cached.stats() == sag::CachingStats{.hits = actions.size() + 2, .misses = 3, .evictions = 2});
+	CHECK(cached.stats().hit_rate() > 0.5);
+
+	// copies start empty
+	Cached const copy = cached;
+	CHECK(copy.capacity() == cached.capacity());
+	CHECK(copy.stats() == sag::CachingStats{});
+
+	// shared by threads: every query is either a hit or a miss
+	Cached const shared{rules, 64};
+	std::vector<S> const roots = rules.list_roots();
+	std::array<bool, 4> same_successors{};  // per thread, as assertions are not thread-safe
+	{
+		std::vector<std::jthread> threads;
+		for (bool& same : same_successors) {
+			threads.emplace_back([&shared, &roots, &rules, &same] {
+				same = std::ranges::all_of(
+					roots, [&](S const& state) { return shared.list_successors(state) == rules.list_successors(state); });
+			});
+		}
+	}
+	CHECK(std::ranges::all_of(same_successors, std::identity{}));
+	sag::CachingStats const stats = shared.stats();
+	CHECK(stats.hits + stats.misses == 4 * roots.size());
+	CHECK(stats.misses >= roots.size());
+	CHECK(stats.misses - stats.evictions <= shared.capacity());
+}
+
+TEST_CASE("Canonical rules test", "[sag]") {
+	// the transforms of a grid are distinct permutations, each with its inverse
+	using Square = sag::GridSymmetries<3, 3>;
+	static_assert(Square::transform_count == 8);
+	static_assert(sag::GridSymmetries<3, 5>::transform_count == 4);
+	for (size_t transform = 0; transform < Square::transform_count; ++transform) {
+		auto const& permutation = Square::permutations[transform];
+		CHECK(std::set<unsigned char>(permutation.begin(), permutation.end()).size() == 9);
+		for (size_t position = 0; position < Square::position_count; ++position)
+			CHECK(Square::permutations[Square::inverses[transform]][Square::permutations[transform][position]] == position);
+	}
+	CHECK(std::set<Square::Permutation>(Square::permutations.begin(), Square::permutations.end()).size() == 8);
+
+	using namespace sag::tic_tac_toe;
+	using Canonical = sag::CanonicalRules<Rules, Symmetry>;
+	static_assert(sag::DeterministicRulesEngine<Canonical, Graph::state, Graph::action>);
+	static_assert(sag::SuccessorListingRulesEngine<Canonical, Graph::state, Graph::action>);
+	Canonical const canonical{};
+
+	auto reachable = [](auto const& rules) {
+		std::vector<Graph::state> queue = rules.list_roots();
+		std::unordered_set<Graph::state> visited(queue.begin(), queue.end());
+		for (size_t head = 0; head < queue.size(); ++head) {
+			for (auto const& [action, edges] : sag::list_successors<Graph::state, Graph::action>(rules, queue[head])) {
+				for (auto const& edge : edges) {
+					if (visited.insert(edge.state()).second)
+						queue.push_back(edge.state());
+				}
+			}
+		}
+		return queue;
+	};
+	std::vector<Graph::state> const states = reachable(Rules{});
+	CHECK(states.size() == 5478);
+	CHECK(reachable(canonical).size() == 765);  // the well known count of essentially different positions
+
+	// actions map to the canonical state and back, successors to symmetric successors
+	for (Graph::state const state : states) {
+		auto const [canonical_state, transform] = Canonical::canonicalize(state);
+		REQUIRE(Canonical::canonicalize(canonical_state).canonical_state == canonical_state);
+		CHECK(Rules::score(state) == canonical.score(canonical_state));
+		std::vector<Graph::action> mapped;
+		for (Graph::action const action : Rules::list_actions(state)) {
+			Graph::action const canonical_action = Canonical::to_canonical(action, transform);
+			CHECK(Canonical::from_canonical(canonical_action, transform) == action);
+			CHECK(Canonical::canonicalize(Rules::list_edges(state, action).front().state()).canonical_state ==
+						canonical.list_edges(canonical_state, canonical_action).front().state());
+			mapped.push_back(canonical_action);
+		}
+		std::ranges::sort(mapped);
+		CHECK(mapped == canonical.list_actions(canonical_state));
+	}
+
+	// santorini 3x3x1: 72 placements of both units, 12 up to symmetry (by Burnside's lemma)
+	constexpr sag::santorini::Dimensions santorini_3x3_1 = {.rows = 3, .cols = 3, .player_unit_count = 1};
+	using SantoriniCanonical =
+		sag::CanonicalRules<sag::santorini::Rules<santorini_3x3_1>, sag::santorini::Symmetry<santorini_3x3_1>>;
+	SantoriniCanonical const santorini{};
+	std::vector<sag::santorini::State<santorini_3x3_1>> const roots = santorini.rules().list_roots();
+	CHECK(roots.size() == 72);
+	CHECK(santorini.list_roots().size() == 12);
+	for (auto const& root : roots) {
+		auto const [canonical_root, transform] = SantoriniCanonical::canonicalize(root);
+		for (sag::santorini::Action const& action : santorini.rules().list_actions(root)) {
+			sag::santorini::Action const canonical_action = SantoriniCanonical::to_canonical(action, transform);
+			CHECK(SantoriniCanonical::from_canonical(canonical_action, transform) == action);
+			auto const successor = santorini.rules().list_edges(root, action).front().state();
+			CHECK(SantoriniCanonical::canonicalize(successor).canonical_state ==
+						santorini.list_edges(canonical_root, canonical_action).front().state());
+		}
+	}
+}
@@ -2,6 +2,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
 #include <random>
 
 #include "sag/GraphConcepts.h"
@@ -25,6 +26,14 @@ struct Defaulted : public G {
 	[[nodiscard]] auto get_printer() const -> typename G::printer { return {}; }
 };
 
+/// replaces the container of a graph collection by the container template C, rooted by the default rules
+template <sag::Graph G, template <typename, typename> class C>
+struct WithContainer : public G {
+	struct container : public C<typename G::state, typename G::action> {
+		container() : C<typename G::state, typename G::action>(typename G::rules{}) {}
+	};
+};
+
 template <typename S, typename A>
 void test_roots_nonterminal(sag::GraphContainer<S, A> auto& graph, sag::RulesEngine<S, A> auto const& rules) {
 	for (S root : graph.roots()) {
@@ -52,6 +61,7 @@ auto descend_once_(
 	float const random_value = randomized ? unit_distribution(rng) : 0.0F;
 
 	auto actions = graph.actions_at(state);
+	REQUIRE(std::ranges::equal(graph.actions_view_at(state), actions));
 	auto action = get_random_element(actions, random_value);
 
 	// test expansion
@@ -60,6 +70,7 @@ auto descend_once_(
 
 	// test edges sum to one
 	auto edges = graph.edges_at(state, action);
+	REQUIRE(std::ranges::equal(graph.edges_view_at(state, action), edges));
 	float weight_sum = 0.0;
 	for (sag::ActionEdge<S> const& edge : edges) {
 		weight_sum += edge.weight().value();
@@ -112,3 +123,24 @@ void test_base_operations(sag::GraphContainer<S, A> auto& graph, sag::RulesEngin
 	}
 	CHECK(terminal_states.size() == 2);
 }
+
+/// Expands all actions breadth-first, starting at the roots, until the graph holds at least `state_limit` states or
+/// is fully expanded. Returns the number of expanded state-actions.
+template <typename S, typename A>
+auto expand_breadth_first(sag::CountingGraphContainer<S, A> auto& graph,
+	sag::RulesEngine<S, A> auto const& rules,
+	size_t state_limit) -> size_t {
+	size_t expansions = 0;
+	std::vector<S> queue = graph.roots();
+	for (size_t head = 0; head < queue.size() && graph.state_count() < state_limit; ++head) {
+		S const state = queue[head];
+		for (A const action : graph.actions_at(state)) {
+			if (!sag::expand(graph, rules, state, action))
+				continue;
+			++expansions;
+			for (sag::ActionEdge<S> const& edge : graph.edges_at(state, action))
+				queue.push_back(edge.state());
+		}
+	}
+	return expansions;
+}
@@ -2,10 +2,12 @@
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
 #include "../helpers.h"
+#include "sag/FrozenGraphContainer.h"
 #include "sag/TicTacToe.h"
 #include "sag/match/MatchRecorder.h"
 #include "sag/match/RandomPlayer.h"
 #include "sag/mcts/MCTSPlayer.h"
+#include "sag/santorini/Graph.h"
 #include "sag/storage/SQLiteMatchStorage.h"
 
 using namespace sag::tic_tac_toe;
@@ -80,4 +82,84 @@ TEST_CASE("Match recorder test", "[sag, match]") {
 	match_count_is_constant = match_count_several_threads == test_storage.count_matches().value();
 	CHECK(match_count_is_constant);
 }
+
+TEST_CASE("Match recorder frozen graph test", "[sag, match]") {
+	struct FrozenGraph : Graph {
+		using container = sag::FrozenGraphContainer<Graph::state, Graph::action>;
+	};
+	using TStorage = sag::storage::SQLiteMatchStorage<sag::storage::IntegerConverter<typename Graph::state>,
+		sag::storage::IntegerConverter<typename Graph::action>>;
+
+	test::TempFilePath const db_file = test::unique_file_path(false);
+	TStorage const test_storage(std::make_unique<tools::SQLiteConnection>(db_file.get(), false));
+	test::TempFilePath const file = test::unique_file_path(false);
+	sag::freeze_graph<Graph::state, Graph::action>(Rules{}, file.get());
+	FrozenGraph::container const graph{file.get()};
+
+	// mcts on the complete graph, without any expansion
+	std::vector<std::unique_ptr<sag::match::Player<FrozenGraph>>> players;
+	players.emplace_back(std::make_unique<sag::mcts::MCTSPlayer<FrozenGraph>>(100));
+	players.emplace_back(std::make_unique<sag::match::RandomPlayer<FrozenGraph>>());
+	FrozenGraph::container copy = graph;
+	CHECK(players.front()->choose_play(graph.roots().front(), copy, Rules{}) > 0);
+	CHECK(copy == graph);
+
+	// the recorder plays matches on its copy of the mapped graph
+	{
+		RecorderThreadHandle<MatchRecorder<FrozenGraph, TStorage>> recorder_thread{
+			MatchRecorder<FrozenGraph, TStorage>{std::move(players),
+				FrozenGraph::container{graph},
+				{},
+				TStorage{std::make_unique<tools::SQLiteConnection>(db_file.get(), false)},
+				std::make_shared<spdlog::logger>("test-recorder")}};
+		recorder_thread.queue().emplace(Signal::Record);
+		std::this_thread::sleep_for(100ms);
+		recorder_thread.queue().emplace(Signal::Quit);
+	}
+	CHECK(test_storage.count_matches().value() > 0);
+}
+
+TEST_CASE("Match recorder frozen santorini graph test", "[sag, match]") {
+	constexpr sag::santorini::Dimensions dim = {.rows = 2, .cols = 3, .player_unit_count = 1};
+	using FrozenGraph = sag::santorini::FrozenGraph<dim>;
+	using TStorage =
+		sag::storage::SQLiteMatchStorage<sag::santorini::StateConverter<dim>, sag::santorini::ActionConverter>;
+
+	test::TempFilePath const db_file = test::unique_file_path(false);
+	TStorage const test_storage(std::make_unique<tools::SQLiteConnection>(db_file.get(), false));
+	test::TempFilePath const file = test::unique_file_path(false);
+	FrozenGraph::rules const rules{};
+	sag::FrozenGraphHeader const header = sag::freeze_graph<FrozenGraph::state, FrozenGraph::action>(rules, file.get());
+	FrozenGraph::container const graph{file.get()};
+	CHECK(graph.state_count() == header.state_count);
+	CHECK(graph.roots() == rules.list_roots());
+
+	// the states are found again by hash and equality, with the actions and edges of the rules
+	for (sag::NodeId node = 0; node < graph.node_count(); ++node) {
+		FrozenGraph::state const state = graph.state_of(node);
+		REQUIRE(graph.node_of(state) == node);
+		std::vector<FrozenGraph::action> actions = rules.list_actions(state);
+		std::ranges::sort(actions);
+		REQUIRE(graph.actions_at(state) == actions);
+		for (FrozenGraph::action const& action : actions)
+			CHECK(graph.edges_at(state, action) == rules.list_edges(state, action));
+	}
+
+	// the recorder plays mcts matches on its copy of the mapped graph
+	std::vector<std::unique_ptr<sag::match::Player<FrozenGraph>>> players;
+	players.emplace_back(std::make_unique<sag::mcts::MCTSPlayer<FrozenGraph>>(100));
+	players.emplace_back(std::make_unique<sag::mcts::MCTSPlayer<FrozenGraph>>(100));
+	{
+		RecorderThreadHandle<MatchRecorder<FrozenGraph, TStorage>> recorder_thread{
+			MatchRecorder<FrozenGraph, TStorage>{std::move(players),
+				FrozenGraph::container{graph},
+				{},
+				TStorage{std::make_unique<tools::SQLiteConnection>(db_file.get(), false)},
+				std::make_shared<spdlog::logger>("test-recorder")}};
+		recorder_thread.queue().emplace(Signal::Record);
+		std::this_thread::sleep_for(100ms);
+		recorder_thread.queue().emplace(Signal::Quit);
+	}
+	CHECK(test_storage.count_matches().value() > 0);
+}
 }  // namespace
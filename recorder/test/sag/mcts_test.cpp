@@ -1,11 +1,21 @@
 
 #include "sag/mcts/MCTS.h"
 
+#include <catch2/catch_template_test_macros.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <random>
+#include <tuple>
 
+#include "../helpers.h"
+
+#include "sag/DeterministicGraphContainer.h"
 #include "sag/ExampleGraph.h"
+#include "sag/InterningGraphContainer.h"
+#include "sag/TicTacToe.h"
 #include "sag/mcts/StatsContainer.h"
+#include "sag/santorini/Bitboard.h"
+#include "sag/santorini/Graph.h"
 
 using namespace sag::example;
 
@@ -54,6 +64,24 @@ auto create_wide_graph_rules() -> Rules {
 	return Rules(graph_structure);
 }
 
+/// Example graph, its states interned into node ids
+struct NodeIndexedGraph : public Graph {
+	struct container : public sag::InterningGraphContainer<Graph::state, Graph::action> {
+		container() : container(Rules({})) {}
+		explicit container(Rules const& rules) : sag::InterningGraphContainer<Graph::state, Graph::action>(rules) {}
+	};
+};
+static_assert(sag::mcts::NodeIndexedGraph<NodeIndexedGraph>);
+
+/// Tic-tac-toe, storing the single successor of each action inline
+struct DeterministicTicTacToe : public sag::tic_tac_toe::Graph {
+	struct container : public sag::DeterministicGraphContainer<state, action> {
+		container() : sag::DeterministicGraphContainer<state, action>(sag::tic_tac_toe::Rules{}) {}
+	};
+};
+static_assert(sag::DeterministicGraph<DeterministicTicTacToe>);
+static_assert(!sag::DeterministicGraph<Graph>);
+
 /// Simple example graph with (true) action values at root '1' are: 1/3 and -1/4
 auto create_small_graph_rules() -> Rules {
 	std::vector<ActionEdges> const TERMINAL = {};
@@ -148,6 +176,82 @@ TEST_CASE("BaseMCTS test (wide graph)", "[sag, mcts]") {
 	CHECK_THAT(result[1], Catch::Matchers::WithinAbs(0.5, 0.05));
 }
 
+TEST_CASE("BaseMCTS test (node indexed graph)", "[sag, mcts]") {
+	Rules const rules = create_small_graph_rules();
+	NodeIndexedGraph::container graph(rules);
+	sag::mcts::StatisticsFor<NodeIndexedGraph> stats;
+	static_assert(std::same_as<decltype(stats), sag::mcts::NodeStatistics>);
+	Graph::state const root = graph.roots()[0];
+
+	// same results as on states (see above), just on node ids
+	sag::mcts::BaseMCTS<NodeIndexedGraph> mcts_algo(true, tools::NonNegative(0.1F));
+	for (size_t i = 0; i < 10'000; i++) {
+		mcts_algo.descend(root, stats, graph, rules);
+	}
+
+	CHECK(stats.size() == graph.node_count());
+	auto result = sag::mcts::action_estimates_at<NodeIndexedGraph>(root, graph, stats);
+	REQUIRE(result.size() == 2);
+	CHECK_THAT(result[0], Catch::Matchers::WithinAbs(1.0 / 3, 0.001));
+	CHECK_THAT(result[1], Catch::Matchers::WithinAbs(-0.25, 0.03));
+}
+
+TEST_CASE("MCTS deterministic graph test", "[sag, mcts]") {
+	using S = DeterministicTicTacToe::state;
+	using A = DeterministicTicTacToe::action;
+	sag::tic_tac_toe::Rules const rules{};
+	DeterministicTicTacToe::container graph{};
+	sag::mcts::Statistics<S> stats;
+	S const root = graph.roots()[0];
+
+	sag::mcts::BaseMCTS<DeterministicTicTacToe> mcts_algo(false, tools::NonNegative(1.0F));
+	for (size_t i = 0; i < 1'000; i++) {
+		mcts_algo.descend(root, stats, graph, rules);
+	}
+
+	// following an action never rolls the random source
+	size_t rolls = 0;
+	std::function<tools::UnitValue(void)> random_source = [&rolls]() {
+		++rolls;
+		return tools::UnitValue{0.5F};
+	};
+	std::function<float(S, A)> const upper_confidence_bound = [&](S state, A action) {
+		return sag::mcts::upper_confidence_bound<DeterministicTicTacToe>(
+			state, action, graph, stats, tools::NonNegative(1.0F));
+	};
+	auto const path =
+		sag::mcts::select<DeterministicTicTacToe>(root, stats, graph, false, upper_confidence_bound, random_source);
+	CHECK(path.values.size() > 1);
+	CHECK(rolls == 0);
+
+	// a rollout rolls once per move (to pick the action), a game takes 5 to 9 moves
+	std::ignore = sag::mcts::random_rollout<DeterministicTicTacToe>(root, graph, rules, random_source);
+	CHECK(rolls >= 5);
+	CHECK(rolls <= 9);
+}
+
+TEST_CASE("MCTS node statistics test", "[mcts]") {
+	sag::mcts::NodeStatistics stats;
+	stats.initialize(3, tools::Score(0.3F));
+	stats.initialize(1, tools::Score(0.1F));
+	stats.initialize(1, tools::Score(0.5F));  // no-op: already initialized
+	CHECK(stats.size() == 2);
+	CHECK(stats.has(1));
+	CHECK_FALSE(stats.has(2));
+	CHECK_FALSE(stats.has(4));
+	CHECK_THROWS(stats.at(2));
+
+	sag::mcts::Path<sag::NodeId> path{.terminal = false, .values = {1, 3}};
+	sag::mcts::update(path, stats);
+	CHECK_THAT(stats.at(1).Q, Catch::Matchers::WithinRel(-0.3F));
+	CHECK(stats.at(1).N == 1);
+	CHECK(stats.at(3).N == 1);
+
+	stats.clear();
+	CHECK(stats.size() == 0);
+	CHECK_FALSE(stats.has(1));
+}
+
 TEST_CASE("MCTS update test", "[mcts]") {
 	sag::mcts::Statistics<Graph::state> stats;
 	stats.initialize(1, tools::Score(0.1F));
@@ -214,3 +318,51 @@ TEST_CASE("MCTS update test", "[mcts]") {
 	CHECK(stats.at(1).N == 0);
 	CHECK(stats.at(4).N == 1);
 }
+
+namespace {
+constexpr sag::santorini::Dimensions santorini_3x5_2 = {.rows = 3, .cols = 5, .player_unit_count = 2};
+}  // namespace
+
+TEMPLATE_TEST_CASE("Graph-free rollout test",
+	"[sag, mcts]",
+	sag::tic_tac_toe::Graph,
+	sag::santorini::Graph<santorini_3x5_2>,
+	sag::santorini::bitboard::Graph<santorini_3x5_2>) {
+	using S = typename TestType::state;
+	using A = typename TestType::action;
+	using R = typename TestType::rules;
+	static_assert(sag::InPlaceRulesEngine<R, S, A>);
+	static_assert(sag::mcts::GraphFreeRolloutGraph<TestType>);
+	R const rules{};
+	typename TestType::container graph{};
+	std::vector<S> const roots = rules.list_roots();
+
+	// applying in place reaches the successor of the edge
+	std::mt19937 rng(17);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible walks
+	for (S state = roots.front(); !rules.list_actions(state).empty();) {
+		std::vector<A> const actions = rules.list_actions(state);
+		A const action = actions[rng() % actions.size()];
+		S const expected = rules.list_edges(state, action)[0].state();
+		rules.apply(state, action);
+		CHECK(state == expected);
+	}
+
+	// same rolls give the same results as on the graph, but without touching the graph or allocating
+	std::mt19937 graph_rng(19);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible rollouts
+	std::mt19937 rules_rng(19);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible rollouts
+	std::uniform_real_distribution<float> distribution(0.0F, 1.0F);
+	std::function<tools::UnitValue(void)> graph_source = [&]() { return tools::UnitValue(distribution(graph_rng)); };
+	std::function<tools::UnitValue(void)> rules_source = [&]() { return tools::UnitValue(distribution(rules_rng)); };
+	std::ignore = sag::mcts::rules_rollout<TestType>(roots.front(), rules, rules_source);  // warm up caches of the rules
+	std::ignore = sag::mcts::random_rollout<TestType>(roots.front(), graph, rules, graph_source);
+	for (int rollout = 0; rollout < 50; ++rollout) {
+		S const root = roots[static_cast<size_t>(rollout) % roots.size()];
+		tools::Score const expected = sag::mcts::random_rollout<TestType>(root, graph, rules, graph_source);
+		size_t const state_count = graph.state_count();
+		test::AllocationCounter const counter;
+		tools::Score const score = sag::mcts::rules_rollout<TestType>(root, rules, rules_source);
+		CHECK(counter.allocations() == 0);
+		CHECK(graph.state_count() == state_count);
+		CHECK(score == expected);
+	}
+}
@@ -1,6 +1,16 @@
 #include "sag/santorini/Santorini.h"
 
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+
+#include "sag/santorini/Bitboard.h"
+#include "sag/santorini/Graph.h"
+#include "sag/santorini/Packed.h"
 
 using namespace sag::santorini;
 
@@ -32,4 +42,242 @@ TEST_CASE("Dimension test", "[sag, santorini]") {
 	}
 }
 
+TEST_CASE("Board encoding test", "[sag, santorini]") {
+	constexpr Dimensions dim_5x5{.rows = 5, .cols = 5, .player_unit_count = 2};
+	constexpr Dimensions dim_3x3{.rows = 3, .cols = 3, .player_unit_count = 1};
+	static_assert(Board<dim_5x5>::powers_of_5.back() == 59'604'644'775'390'625ULL);  // 5^24
+	static_assert(Board<dim_3x3>::decode_base5(Board<dim_3x3>::powers_of_5[4]).at({1, 1}) == BoardState::First);
+
+	std::mt19937 rng(3);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible boards
+	auto random_board = [&rng]<Dimensions dim>(Board<dim> /*tag*/) {
+		std::array<BoardState, dim.position_count()> data{};
+		for (BoardState& entry : data)
+			entry = static_cast<BoardState>(rng() % static_cast<unsigned>(BoardState::VALUE_COUNT));
+		return Board<dim>{data};
+	};
+
+	std::vector<Board<dim_5x5>> boards;
+	std::vector<unsigned long long> encoded;
+	for (int i = 0; i < 1'000; ++i) {
+		boards.push_back(random_board(Board<dim_5x5>{}));
+		encoded.push_back(boards.back().encode_base5());
+		REQUIRE(Board<dim_5x5>::decode_base5(encoded.back()) == boards.back());
+		for (unsigned char row = 0; row < dim_5x5.rows; ++row) {
+			for (unsigned char col = 0; col < dim_5x5.cols; ++col)
+				CHECK(Board<dim_5x5>::decode_base5_at(encoded.back(), {row, col}) == boards.back().at({row, col}));
+		}
+	}
+	CHECK(*std::ranges::max_element(encoded) < Board<dim_5x5>::powers_of_5.back() * 5);
+
+	std::vector<Board<dim_5x5>> decoded(encoded.size());
+	Board<dim_5x5>::decode_base5(encoded, decoded);
+	CHECK(decoded == boards);
+
+	// as the previous encoding (pow per position), where the powers of 5 are exact doubles
+	for (int i = 0; i < 1'000; ++i) {
+		Board<dim_3x3> const board = random_board(Board<dim_3x3>{});
+		unsigned long long expected = 0;
+		for (size_t k = 0; k < dim_3x3.position_count(); ++k) {
+			expected += static_cast<unsigned long long>(board.underlying_array()[k]) *
+									static_cast<unsigned long long>(pow(5.0, static_cast<double>(k)));
+		}
+		CHECK(board.encode_base5() == expected);
+	}
+}
+
+TEST_CASE("Board cache test", "[sag, santorini]") {
+	static constexpr Dimensions dim{.rows = 3, .cols = 3, .player_unit_count = 1};
+	Rules<dim> const rules{};
+
+	// an expansion decodes each board once: actions, score and successors of a state are hits after the first access
+	State<dim> const root = rules.list_roots().back();
+	State<dim> const state = rules.list_edges(root, rules.list_actions(root).front()).front().state();
+	CacheStats const before = Rules<dim>::board_cache_stats();
+	std::vector<Action> const actions = rules.list_actions(state);
+	CHECK(rules.score(state).value() == 0.0F);
+	for (Action const& action : actions)
+		CHECK(rules.list_edges(state, action).size() == 1);
+	CHECK_FALSE(rules.to_string(state).empty());
+	CacheStats const after = Rules<dim>::board_cache_stats();
+	CHECK(after.misses - before.misses <= 1);
+	CHECK(after.hits - before.hits >= actions.size() + 2);
+	CHECK(after.hit_rate() > 0.0);
+
+	// each thread has its own cache, and copies of the rules may run in parallel
+	auto walk = [](Rules<dim> const& own_rules) {
+		std::mt19937 rng(1);  // NOLINT(cert-msc32-c, cert-msc51-cpp): same walk in all threads
+		std::vector<std::string> visited;
+		CacheStats const start = Rules<dim>::board_cache_stats();
+		for (int match = 0; match < 20; ++match) {
+			State<dim> current = own_rules.list_roots().front();
+			for (auto actions_at = own_rules.list_actions(current); !actions_at.empty();
+					 actions_at = own_rules.list_actions(current)) {
+				visited.push_back(own_rules.to_string(current));
+				current = own_rules.list_edges(current, actions_at[rng() % actions_at.size()]).front().state();
+			}
+		}
+		CacheStats const end = Rules<dim>::board_cache_stats();
+		CacheStats const walk_stats{.hits = end.hits - start.hits, .misses = end.misses - start.misses};
+		return std::tuple{visited, walk_stats, end};
+	};
+	auto const [expected_walk, main_walk_stats, main_stats] = walk(rules);
+	std::vector<std::tuple<std::vector<std::string>, CacheStats, CacheStats>> results(4);
+	{
+		std::vector<std::jthread> threads;
+		for (auto& result : results)
+			threads.emplace_back([&result, &walk, copy = rules] { result = walk(copy); });
+	}
+	for (auto const& [visited, walk_stats, stats] : results) {
+		CHECK(visited == expected_walk);
+		// the same lookups as the walk of the main thread, counted by a fresh cache of the thread only
+		CHECK(walk_stats.hits + walk_stats.misses == main_walk_stats.hits + main_walk_stats.misses);
+		CHECK(stats == walk_stats);
+	}
+}
+
+/// compares both engines on the given state (of the base-5 engine) and returns its successors
+template <Dimensions dim>
+auto compare_engines(Rules<dim> const& rules, bitboard::Rules<dim> const& bitboard_rules, State<dim> const& state)
+	-> std::vector<State<dim>> {
+	bitboard::State<dim> const bitboard_state = bitboard::to_bitboard(state);
+	REQUIRE(bitboard::from_bitboard(bitboard_state) == state);
+
+	std::vector<Action> const actions = rules.list_actions(state);
+	REQUIRE(bitboard_rules.list_actions(bitboard_state) == actions);
+	CHECK(bitboard_rules.score(bitboard_state) == rules.score(state));
+	CHECK(bitboard_rules.to_string(bitboard_state) == rules.to_string(state));
+
+	std::vector<State<dim>> successors;
+	for (Action const& action : actions) {
+		State<dim> const successor = rules.list_edges(state, action).front().state();
+		REQUIRE(bitboard::from_bitboard(bitboard_rules.list_edges(bitboard_state, action).front().state()) == successor);
+		successors.push_back(successor);
+	}
+	return successors;
+}
+
+TEST_CASE("Zobrist hashing test", "[sag, santorini]") {
+	constexpr Dimensions dim{.rows = 5, .cols = 5, .player_unit_count = 2};
+	using Keys = ZobristKeys<dim>;
+	Rules<dim> const rules{};
+	static_assert(Keys::height({0, 0}, BoardState::Empty) == 0);
+	static_assert(Keys::unit(Keys::player, 0, {0, 0}) != Keys::unit(Keys::opponent, 0, {0, 0}));
+	static_assert(Keys::unit(Keys::player, 0, {0, 0}) != Keys::unit(Keys::player, 1, {0, 0}));
+
+	// the incremental key of random walks equals the key computed from scratch
+	std::mt19937 rng(5);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible walks
+	std::vector<State<dim>> const roots = rules.list_roots();
+	std::unordered_set<State<dim>> states;
+	std::unordered_set<std::uint64_t> keys;
+	for (int walk = 0; walk < 200; ++walk) {
+		State<dim> state = roots[rng() % roots.size()];
+		for (std::vector<Action> actions = rules.list_actions(state); !actions.empty();
+				 actions = rules.list_actions(state)) {
+			state = rules.list_edges(state, actions[rng() % actions.size()]).front().state();
+			State<dim> const recomputed{state.units_player, state.units_opponent, state.board_base5.to_ullong()};
+			REQUIRE(state.zobrist_key == recomputed.zobrist_key);
+			REQUIRE(state == recomputed);
+			CHECK(std::hash<State<dim>>{}(state) == state.zobrist_key);
+			states.insert(state);
+			keys.insert(state.zobrist_key);
+		}
+	}
+	CHECK(keys.size() == states.size());
+
+	// states differing only in the owners or numbers of their units
+	State<dim> const state{{Position{0, 0}, Position{1, 1}}, {Position{2, 2}, Position{3, 3}}, 0ULL};
+	CHECK(state.zobrist_key !=
+				State<dim>{{Position{2, 2}, Position{3, 3}}, {Position{0, 0}, Position{1, 1}}, 0ULL}.zobrist_key);
+	CHECK(state.zobrist_key !=
+				State<dim>{{Position{1, 1}, Position{0, 0}}, {Position{2, 2}, Position{3, 3}}, 0ULL}.zobrist_key);
+
+	// default states have the key of their members
+	State<dim> const default_state{};
+	CHECK(default_state == State<dim>{{}, {}, 0ULL});
+	CHECK(default_state.zobrist_key == ZobristKeys<dim>::key_of({}, {}, 0ULL));
+}
+
+TEST_CASE("Packed state test", "[sag, santorini]") {
+	constexpr Dimensions dim{.rows = 5, .cols = 5, .player_unit_count = 2};
+	// the saving of states is the Zobrist key, which packed states do not store (the units and board fit in 16 bytes
+	// either way), but their bytes are fully defined: no padding
+	static_assert(sizeof(PackedState<dim>) < sizeof(State<dim>));
+	static_assert(std::has_unique_object_representations_v<PackedState<dim>>);
+	static_assert(sizeof(PackedAction<dim>) < sizeof(Action));
+	Rules<dim> const rules{};
+	PackedRules<dim> const packed_rules{};
+
+	// packing round trips along random walks, with the same actions and successors as the unpacked rules
+	std::mt19937 rng(11);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible walks
+	std::vector<State<dim>> const roots = rules.list_roots();
+	std::unordered_set<PackedState<dim>> packed_states;
+	std::unordered_set<State<dim>> states;
+	for (int walk = 0; walk < 100; ++walk) {
+		State<dim> state = roots[rng() % roots.size()];
+		for (std::vector<Action> actions = rules.list_actions(state); !actions.empty();
+				 actions = rules.list_actions(state)) {
+			PackedState<dim> const packed = PackedState<dim>::pack(state);
+			REQUIRE(packed.unpack() == state);
+			std::vector<PackedAction<dim>> const packed_actions = packed_rules.list_actions(packed);
+			REQUIRE(packed_actions.size() == actions.size());
+			auto const successors = packed_rules.list_successors(packed);
+			REQUIRE(successors.size() == actions.size());
+			for (size_t index = 0; index < actions.size(); ++index) {
+				REQUIRE(packed_actions[index].unpack() == actions[index]);
+				CHECK(successors[index].first == packed_actions[index]);
+				CHECK(successors[index].second.front().state() ==
+							PackedState<dim>::pack(rules.list_edges(state, actions[index]).front().state()));
+			}
+			size_t const choice = rng() % actions.size();
+			State<dim> const next = rules.list_edges(state, actions[choice]).front().state();
+			CHECK(packed_rules.list_edges(packed, packed_actions[choice]).front().state() == PackedState<dim>::pack(next));
+			CHECK(packed_rules.score(packed) == rules.score(state));
+			packed_states.insert(packed);
+			states.insert(state);
+			state = next;
+		}
+	}
+	CHECK(packed_states.size() == states.size());
+}
+
+TEST_CASE("Santorini bitboard rules test", "[sag, santorini]") {
+	SECTION("roots") {
+		constexpr Dimensions dim{.rows = 3, .cols = 4, .player_unit_count = 2};
+		std::vector<bitboard::State<dim>> bitboard_roots;
+		for (State<dim> const& root : Rules<dim>{}.list_roots())
+			bitboard_roots.push_back(bitboard::to_bitboard(root));
+		CHECK(bitboard::Rules<dim>{}.list_roots() == bitboard_roots);
+	}
+
+	SECTION("all states of 2x2x1") {
+		constexpr Dimensions dim{.rows = 2, .cols = 2, .player_unit_count = 1};
+		Rules<dim> const rules{};
+		bitboard::Rules<dim> const bitboard_rules{};
+		std::vector<State<dim>> queue = rules.list_roots();
+		std::unordered_set<State<dim>> known(queue.begin(), queue.end());
+		for (size_t head = 0; head < queue.size(); ++head) {
+			for (State<dim> const& successor : compare_engines(rules, bitboard_rules, queue[head])) {
+				if (known.insert(successor).second)
+					queue.push_back(successor);
+			}
+		}
+		CHECK(queue.size() == 828);  // all reachable states
+	}
+
+	SECTION("random matches on 5x5x2") {
+		constexpr Dimensions dim{.rows = 5, .cols = 5, .player_unit_count = 2};
+		Rules<dim> const rules{};
+		bitboard::Rules<dim> const bitboard_rules{};
+		std::vector<State<dim>> const roots = rules.list_roots();
+		std::mt19937 rng(11);  // NOLINT(cert-msc32-c, cert-msc51-cpp): reproducible matches
+		for (int match = 0; match < 50; ++match) {
+			State<dim> state = roots[rng() % roots.size()];
+			for (auto successors = compare_engines(rules, bitboard_rules, state); !successors.empty();
+					 successors = compare_engines(rules, bitboard_rules, state)) {
+				state = successors[rng() % successors.size()];
+			}
+		}
+	}
+}
+
 }  // namespace